@@ -109,3 +109,7 @@ namespace lvk::context
         LVK_ASSERT(log_file_##var.good())                                                                              \
     }                                                                                                                  \
     static lvk::CSVLogger _##var(log_file_##var)
+
+// NOTE: Resulting AsyncCSVLogger will be named '_var', prefer this in hot paths
+#define INIT_ASYNC_CSV(var, path, ...)                                                                                 \
+    static lvk::AsyncCSVLogger _##var(path, {__VA_ARGS__})
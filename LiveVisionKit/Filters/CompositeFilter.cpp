@@ -64,8 +64,73 @@ namespace lvk
     {
         LVK_ASSERT(!input.is_empty());
 
-        Frame& prev_filter_output = input;
+        run_chain(0, std::move(input), output, debug);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool CompositeFilter::pending_output(Frame& output, const bool debug)
+    {
+        // The pending frames of later filters come before any still pending upstream,
+        // so the chain is drained from its end. Each frame released by a filter must
+        // also pass through the rest of the chain, which may produce pending frames.
+        for(size_t i = m_Settings.filter_chain.size(); i-- > 0;)
+        {
+            if(!is_filter_enabled(i))
+                continue;
+
+            while(m_Settings.filter_chain[i]->pending_output(m_FlushBuffer, debug))
+            {
+                if(m_FlushBuffer.is_empty())
+                    continue;
+
+                run_chain(i + 1, std::move(m_FlushBuffer), output, debug);
+                if(!output.is_empty())
+                    return true;
+            }
+        }
+
+        output.release();
+        return false;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool CompositeFilter::flush(Frame& output, const bool debug)
+    {
+        // Flush the filters in order, passing any frames they were holding
+        // through the rest of the chain, which may in turn hold onto them.
         for(size_t i = 0; i < m_Settings.filter_chain.size(); i++)
+        {
+            if(!is_filter_enabled(i))
+                continue;
+
+            while(m_Settings.filter_chain[i]->flush(m_FlushBuffer, debug))
+            {
+                if(m_FlushBuffer.is_empty())
+                    continue;
+
+                run_chain(i + 1, std::move(m_FlushBuffer), output, debug);
+                if(!output.is_empty())
+                    return true;
+            }
+        }
+
+        output.release();
+        return false;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void CompositeFilter::run_chain(
+        const size_t start,
+        Frame&& input,
+        Frame& output,
+        const bool debug
+    )
+    {
+        Frame& prev_filter_output = input;
+        for(size_t i = start; i < m_Settings.filter_chain.size(); i++)
         {
             if(is_filter_enabled(i))
             {
@@ -64,6 +64,10 @@ namespace lvk
 
         size_t filter_count() const;
 
+        bool pending_output(Frame& output, const bool debug = false) override;
+
+        bool flush(Frame& output, const bool debug = false) override;
+
     private:
 
         void filter(
@@ -73,8 +77,16 @@ namespace lvk
             const bool debug
         ) override;
 
+        void run_chain(
+            const size_t start,
+            Frame&& input,
+            Frame& output,
+            const bool debug
+        );
+
         std::vector<bool> m_FilterRunState;
         std::vector<Frame> m_FilterOutputs;
+        Frame m_FlushBuffer;
     };
 
 }
@@ -41,6 +41,20 @@ namespace lvk
         m_Settings = settings;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool ConversionFilter::is_stateless() const
+    {
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<VideoFilter> ConversionFilter::clone() const
+    {
+        return std::make_shared<ConversionFilter>(m_Settings);
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void ConversionFilter::filter(
@@ -52,12 +66,27 @@ namespace lvk
     {
         LVK_ASSERT(!input.is_empty());
 
-        cv::cvtColor(
-            input.data,
-            input.data,
-            m_Settings.conversion_code,
-            static_cast<int>(m_Settings.output_channels.value_or(0))
-        );
+        // OpenCV can't convert half float frames directly, so they are converted as full floats.
+        if(input.data.depth() == CV_16F)
+        {
+            input.data.convertTo(m_FloatBuffer, CV_32F);
+            cv::cvtColor(
+                m_FloatBuffer,
+                m_FloatBuffer,
+                m_Settings.conversion_code,
+                static_cast<int>(m_Settings.output_channels.value_or(0))
+            );
+            m_FloatBuffer.convertTo(input.data, CV_16F);
+        }
+        else
+        {
+            cv::cvtColor(
+                input.data,
+                input.data,
+                m_Settings.conversion_code,
+                static_cast<int>(m_Settings.output_channels.value_or(0))
+            );
+        }
 
         output = std::move(input);
     }
@@ -41,6 +41,10 @@ namespace lvk
 
         void configure(const ConversionFilterSettings& settings) override;
 
+        bool is_stateless() const override;
+
+        std::shared_ptr<VideoFilter> clone() const override;
+
     private:
 
         void filter(
@@ -50,6 +54,8 @@ namespace lvk
             const bool debug
         ) override;
 
+    private:
+        cv::UMat m_FloatBuffer;
     };
 
 }
@@ -18,6 +18,7 @@
 #include "DeblockingFilter.hpp"
 
 #include "Functions/Drawing.hpp"
+#include "Functions/OpenCL/Kernels.hpp"
 
 namespace lvk
 {
@@ -43,6 +44,20 @@ namespace lvk
         m_Settings = settings;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool DeblockingFilter::is_stateless() const
+    {
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<VideoFilter> DeblockingFilter::clone() const
+    {
+        return std::make_shared<DeblockingFilter>(m_Settings);
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void DeblockingFilter::filter(
@@ -53,71 +68,324 @@ namespace lvk
     )
 	{
         LVK_ASSERT(!input.is_empty());
+        LVK_ASSERT(input.data.channels() == 3);
+
+        const int depth = input.data.depth();
+        LVK_ASSERT(depth == CV_8U || depth == CV_16U || depth == CV_16F);
 
 		// NOTE: De-blocking is achieved by adaptively blending a median smoothed
 		// frame with the original. Filtering occurs on a downscaled frame to boost
-		// its performance and effective area. Blend maps are made by comparing the
-		// original frame with a reference maximal blocking artifact frame, created
-		// by simplifying each block to its average value. Not all frame resolutions
-		// fit an integer number of macroblocks, so the frame must be padded or cropped.
-		// Both these techniques lead to approximately the same result, so cropping
-		// is preferred for performance. Blocks are assumed to be safe to smooth if
-		// they are similar, by threshold,to the reference blocks. To make the choice
-		// of threshold less strict for the user; multiple thresholds are used, each
-		// with their own weighting that increases as details become stronger.
+		// its performance and effective area. Blend weights are made per macroblock
+		// by comparing the original frame with a reference maximal blocking artifact
+		// frame, created by simplifying each block to its average value. Not all frame
+		// resolutions fit an integer number of macroblocks, so the frame must be padded
+		// or cropped. Both these techniques lead to approximately the same result, so
+		// cropping is preferred for performance. Blocks are assumed to be safe to smooth
+		// if they are similar, by threshold, to the reference blocks. To make the choice
+		// of threshold less strict for the user; multiple thresholds are used, each with
+		// their own weighting that increases as details become stronger.
+		//
+		// The weights and blending are each fused into a single pass over the frame,
+		// so that no full resolution intermediate maps are ever needed.
 
 		const int macroblock_size = static_cast<int>(m_Settings.block_size);
 		const cv::Size macroblock_extent = input.size() / macroblock_size;
 		const cv::Rect macroblock_region({0,0}, macroblock_extent * macroblock_size);
 
+		if(macroblock_region.empty())
+		{
+			output = std::move(input);
+			return;
+		}
+
+		// Generate the downscaled smooth frame, this is upscaled on the fly during blending.
 		// Resolutions such as 1920x1080 may not be evenly divisible by macroblocks.
 		// We ignore areas containing partial blocks by applying the filter on only
 		// the region of the frame which consists of only full macroblocks.
-		cv::UMat filter_region = input.data(macroblock_region);
-
-		// Generate smooth frame
+		//
+		// NOTE: half float frames are smoothed as full floats, as OpenCV can't resize or
+		// median filter them. OpenCV also only supports median filters larger than 5 on
+		// 8-bit frames, so the filter size is limited for higher bit depths.
 		const float area_scaling = 1.0f / m_Settings.filter_scaling;
-		cv::resize(filter_region, m_DeblockBuffer, cv::Size(), area_scaling, area_scaling, cv::INTER_AREA);
-		cv::medianBlur(m_DeblockBuffer, m_DeblockBuffer, static_cast<int>(m_Settings.filter_size));
-		cv::resize(m_DeblockBuffer, m_SmoothFrame, macroblock_region.size(), 0, 0, cv::INTER_LINEAR);
-
-		// Generate reference frame
-		cv::extractChannel(filter_region, m_DetectionFrame, 0);
-		cv::resize(m_DetectionFrame, m_BlockGrid, macroblock_extent, 0, 0, cv::INTER_AREA);
-		cv::resize(m_BlockGrid, m_ReferenceFrame, m_DetectionFrame.size(), 0, 0, cv::INTER_NEAREST);
-		cv::absdiff(m_DetectionFrame, m_ReferenceFrame, m_DetectionFrame);
-		cv::resize(m_DetectionFrame, m_BlockGrid, macroblock_extent, 0, 0, cv::INTER_AREA);
-
-		// Produce blend maps
-		m_FloatBuffer.create(macroblock_extent, CV_32FC1);
-		m_FloatBuffer.setTo(cv::Scalar(0.0));
-
-		const double level_step = 1.0 / m_Settings.detection_levels;
-		for(int l = 0; l < m_Settings.detection_levels; l++)
+		if(depth == CV_16F)
 		{
-			cv::threshold(m_BlockGrid, m_BlockMask, l, 255, cv::THRESH_BINARY);
-			m_FloatBuffer.setTo(cv::Scalar((l + 1.0) * level_step), m_BlockMask);
+			input.data(macroblock_region).convertTo(m_SmoothFrame, CV_32F);
+			cv::resize(m_SmoothFrame, m_SmoothFrame, cv::Size(), area_scaling, area_scaling, cv::INTER_AREA);
 		}
+		else cv::resize(input.data(macroblock_region), m_SmoothFrame, cv::Size(), area_scaling, area_scaling, cv::INTER_AREA);
 
-		cv::resize(m_FloatBuffer, m_KeepBlendMap, filter_region.size(), 0, 0, cv::INTER_LINEAR);
-		cv::absdiff(m_KeepBlendMap, cv::Scalar(1.0), m_DeblockBlendMap);
+		const int filter_size = static_cast<int>(m_Settings.filter_size);
+		cv::medianBlur(m_SmoothFrame, m_SmoothFrame, depth == CV_8U ? filter_size : std::min(filter_size, 5));
 
 		// Set smoothing frame to magenta so that we can see all the detection levels.
 		if(debug)
-			m_SmoothFrame.setTo(yuv::MAGENTA);
-
-		// Adaptively blend original and smooth frames
-		cv::blendLinear(
-            filter_region,
-            m_SmoothFrame,
-            m_KeepBlendMap,
-            m_DeblockBlendMap,
-            filter_region
-		);
+		{
+			const double colour_scale = depth == CV_8U ? 1.0 : (depth == CV_16U ? 257.0 : 1.0 / 255.0);
+			m_SmoothFrame.setTo(yuv::MAGENTA * colour_scale);
+		}
+
+		if(cv::ocl::useOpenCL())
+			deblock_opencl(input.data, macroblock_region);
+		else
+			deblock_cpu(input, macroblock_region);
 
         output = std::move(input);
 	}
 
+//---------------------------------------------------------------------------------------------------------------------
+
+	void DeblockingFilter::deblock_opencl(cv::UMat& frame, const cv::Rect& region)
+	{
+		static auto program_8u = ocl::load_program("deblocking", ocl::src::deblocking_source);
+		static auto program_16u = ocl::load_program("deblocking", ocl::src::deblocking_source, "-D DEPTH_16U");
+		static auto program_16f = ocl::load_program("deblocking", ocl::src::deblocking_source, "-D DEPTH_16F");
+		LVK_ASSERT(!program_8u.empty() && !program_16u.empty() && !program_16f.empty());
+
+		const auto& program = frame.depth() == CV_16U ? program_16u : (frame.depth() == CV_16F ? program_16f : program_8u);
+
+		cv::UMat filter_region = frame(region);
+		m_BlockWeights.create(region.size() / static_cast<int>(m_Settings.block_size), CV_32FC1);
+
+		size_t global_work_size[3], local_work_size[3];
+
+		// Pass 1: find the blend weight of each macroblock.
+		ocl::optimal_groups(m_BlockWeights, global_work_size, local_work_size);
+		ocl::dispatch(
+			program,
+			"block_weights",
+			2, global_work_size, local_work_size,
+			cv::ocl::KernelArg::ReadOnly(filter_region),
+			cv::ocl::KernelArg::WriteOnly(m_BlockWeights),
+			static_cast<int>(m_Settings.block_size),
+			static_cast<int>(m_Settings.detection_levels)
+		);
+
+		// Pass 2: smooth and blend each pixel in place.
+		ocl::optimal_groups(filter_region, global_work_size, local_work_size);
+		ocl::dispatch(
+			program,
+			"deblock_blend",
+			2, global_work_size, local_work_size,
+			cv::ocl::KernelArg::ReadWrite(filter_region),
+			cv::ocl::KernelArg::ReadOnly(m_SmoothFrame),
+			cv::ocl::KernelArg::ReadOnly(m_BlockWeights)
+		);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	// Matches the source coordinates used by OpenCV's bilinear resize.
+	static void linear_sample_coords(const int coord, const float scale, const int size, int& c0, int& c1, float& t)
+	{
+		const float source = std::max((static_cast<float>(coord) + 0.5f) * scale - 0.5f, 0.0f);
+		const int base = static_cast<int>(source);
+
+		t = (base >= size - 1) ? 0.0f : source - static_cast<float>(base);
+		c0 = std::min(base, size - 1);
+		c1 = std::min(base + 1, size - 1);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	// Pixel values are converted to 8-bit units for detection, so the thresholds stay the same.
+	template<typename P>
+	static constexpr float luma_scale()
+	{
+		if constexpr(std::is_same_v<P, uint16_t>)
+			return 255.0f / 65535.0f;
+		else if constexpr(std::is_same_v<P, cv::float16_t>)
+			return 255.0f;
+		else
+			return 1.0f;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	// P is the frame pixel type, S is the smooth frame pixel type.
+	template<typename P, typename S>
+	static void deblock_bands(
+		const cv::Mat& src,
+		const cv::Mat& smooth,
+		cv::Mat& dst,
+		const cv::Rect& region,
+		const DeblockingFilterSettings& settings
+	)
+	{
+		const int block_size = static_cast<int>(settings.block_size);
+		const int detection_levels = static_cast<int>(settings.detection_levels);
+		const cv::Size block_extent = region.size() / block_size;
+		if(block_extent.empty()) return;
+
+		// Tiles span whole rows of macroblocks where the budget allows, so that their rows
+		// are contiguous in memory. Otherwise, such as at 8K, each tile is a single row of
+		// macroblocks which is split across its columns instead.
+		int band_blocks = block_extent.height, tile_blocks = block_extent.width;
+		if(settings.cpu_cache_budget > 0)
+		{
+			const size_t budget = static_cast<size_t>(settings.cpu_cache_budget) * 1024;
+			const size_t block_bytes = static_cast<size_t>(block_size * block_size) * (src.elemSize() + dst.elemSize());
+			const size_t block_row_bytes = block_bytes * static_cast<size_t>(block_extent.width);
+
+			if(block_row_bytes <= budget)
+				band_blocks = static_cast<int>(std::min<size_t>(budget / block_row_bytes, block_extent.height));
+			else
+			{
+				band_blocks = 1;
+				tile_blocks = static_cast<int>(std::max<size_t>(budget / block_bytes, 1));
+			}
+		}
+		const int band_count = (block_extent.height + band_blocks - 1) / band_blocks;
+		const int column_count = (block_extent.width + tile_blocks - 1) / tile_blocks;
+
+		const float block_area = static_cast<float>(block_size * block_size);
+		const auto block_weight = [&](const int bx, const int by)
+		{
+			const int x0 = bx * block_size, y0 = by * block_size;
+
+			// Find the average luma of the block, this is the maximal blocking artifact reference.
+			float luma_sum = 0.0f;
+			for(int y = y0; y < y0 + block_size; y++)
+			{
+				const auto* row = src.ptr<P>(y) + 3 * x0;
+				for(int x = 0; x < block_size; x++)
+					luma_sum += static_cast<float>(row[3 * x]) * luma_scale<P>();
+			}
+			const float reference = static_cast<float>(cvRound(luma_sum / block_area));
+
+			float deviation_sum = 0.0f;
+			for(int y = y0; y < y0 + block_size; y++)
+			{
+				const auto* row = src.ptr<P>(y) + 3 * x0;
+				for(int x = 0; x < block_size; x++)
+					deviation_sum += std::abs(static_cast<float>(row[3 * x]) * luma_scale<P>() - reference);
+			}
+			const int deviation = cvRound(deviation_sum / block_area);
+
+			return static_cast<float>(std::min(deviation, detection_levels))
+				/ static_cast<float>(detection_levels);
+		};
+
+		cv::parallel_for_(cv::Range(0, band_count * column_count), [&](const cv::Range& range)
+		{
+			thread_local cv::Mat weights;
+
+			for(int t = range.start; t < range.end; t++)
+			{
+				const int first_block_row = (t / column_count) * band_blocks;
+				const int last_block_row = std::min(first_block_row + band_blocks, block_extent.height);
+				const int first_block_col = (t % column_count) * tile_blocks;
+				const int last_block_col = std::min(first_block_col + tile_blocks, block_extent.width);
+
+				// Pass 1: find the blend weights of the tile's blocks.
+				const int first_weight_row = std::max(first_block_row - 1, 0);
+				const int last_weight_row = std::min(last_block_row + 1, block_extent.height);
+				const int first_weight_col = std::max(first_block_col - 1, 0);
+				const int last_weight_col = std::min(last_block_col + 1, block_extent.width);
+
+				weights.create(last_weight_row - first_weight_row, last_weight_col - first_weight_col, CV_32FC1);
+				for(int by = first_weight_row; by < last_weight_row; by++)
+				{
+					auto* weight_row = weights.ptr<float>(by - first_weight_row);
+					for(int bx = first_weight_col; bx < last_weight_col; bx++)
+						weight_row[bx - first_weight_col] = block_weight(bx, by);
+				}
+
+				// Pass 2: smooth and blend each pixel of the tile.
+				const float weight_scale = 1.0f / static_cast<float>(block_size);
+				const float smooth_scale_x = static_cast<float>(smooth.cols) / static_cast<float>(region.width);
+				const float smooth_scale_y = static_cast<float>(smooth.rows) / static_cast<float>(region.height);
+
+				for(int y = first_block_row * block_size; y < last_block_row * block_size; y++)
+				{
+					int wy0, wy1, sy0, sy1; float wty, sty;
+					linear_sample_coords(y, weight_scale, block_extent.height, wy0, wy1, wty);
+					linear_sample_coords(y, smooth_scale_y, smooth.rows, sy0, sy1, sty);
+
+					const auto* weight_row0 = weights.ptr<float>(wy0 - first_weight_row);
+					const auto* weight_row1 = weights.ptr<float>(wy1 - first_weight_row);
+					const auto* smooth_row0 = smooth.ptr<S>(sy0);
+					const auto* smooth_row1 = smooth.ptr<S>(sy1);
+					const auto* src_row = src.ptr<P>(y);
+					auto* dst_row = dst.ptr<P>(y);
+
+					for(int x = first_block_col * block_size; x < last_block_col * block_size; x++)
+					{
+						int wx0, wx1, sx0, sx1; float wtx, stx;
+						linear_sample_coords(x, weight_scale, block_extent.width, wx0, wx1, wtx);
+						wx0 -= first_weight_col;
+						wx1 -= first_weight_col;
+						linear_sample_coords(x, smooth_scale_x, smooth.cols, sx0, sx1, stx);
+
+						const float keep_top = weight_row0[wx0] + (weight_row0[wx1] - weight_row0[wx0]) * wtx;
+						const float keep_bottom = weight_row1[wx0] + (weight_row1[wx1] - weight_row1[wx0]) * wtx;
+						const float keep = keep_top + (keep_bottom - keep_top) * wty;
+
+						for(int c = 0; c < 3; c++)
+						{
+							const auto s00 = static_cast<float>(smooth_row0[3 * sx0 + c]);
+							const auto s01 = static_cast<float>(smooth_row0[3 * sx1 + c]);
+							const auto s10 = static_cast<float>(smooth_row1[3 * sx0 + c]);
+							const auto s11 = static_cast<float>(smooth_row1[3 * sx1 + c]);
+
+							const float smooth_top = s00 + (s01 - s00) * stx;
+							const float smooth_bottom = s10 + (s11 - s10) * stx;
+							const float smooth_value = smooth_top + (smooth_bottom - smooth_top) * sty;
+
+							const auto original = static_cast<float>(src_row[3 * x + c]);
+							dst_row[3 * x + c] = cv::saturate_cast<P>(smooth_value + (original - smooth_value) * keep);
+						}
+					}
+				}
+			}
+		});
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void DeblockingFilter::deblock_cpu(Frame& frame, const cv::Rect& region)
+	{
+		// The frame is split into tiles of macroblocks, which are filtered in parallel. Each
+		// tile finds the weights of its blocks, plus those of the neighbouring blocks reached
+		// by the weight interpolation, then blends its pixels while they're still in cache.
+		// The tiles are read from the untouched input and written to a separate output, so
+		// that neighbouring tiles never observe each other's output.
+		m_OutputFrame.create(frame.size(), frame.type());
+		{
+			const cv::Mat src = frame.data.getMat(cv::ACCESS_READ);
+			const cv::Mat smooth = m_SmoothFrame.getMat(cv::ACCESS_READ);
+			cv::Mat dst = m_OutputFrame.getMat(cv::ACCESS_WRITE);
+
+			// NOTE: the partial macroblocks along the right and bottom edges
+			// are never filtered, so they are copied over as they are.
+			if(region.width < src.cols)
+			{
+				const cv::Rect right_strip(region.width, 0, src.cols - region.width, src.rows);
+				src(right_strip).copyTo(dst(right_strip));
+			}
+			if(region.height < src.rows)
+			{
+				const cv::Rect bottom_strip(0, region.height, region.width, src.rows - region.height);
+				src(bottom_strip).copyTo(dst(bottom_strip));
+			}
+
+			switch(src.depth())
+			{
+				case CV_16U:
+					deblock_bands<uint16_t, uint16_t>(src, smooth, dst, region, m_Settings);
+					break;
+				case CV_16F:
+					deblock_bands<cv::float16_t, float>(src, smooth, dst, region, m_Settings);
+					break;
+				default:
+					deblock_bands<uint8_t, uint8_t>(src, smooth, dst, region, m_Settings);
+					break;
+			}
+		}
+
+		// Swap the buffers so the old input frame is re-used for the next output.
+		std::swap(frame.data, m_OutputFrame);
+	}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 }
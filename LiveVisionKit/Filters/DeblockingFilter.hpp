@@ -29,6 +29,10 @@ namespace lvk
 		uint32_t block_size = 16; // Must be greater than 0
 		uint32_t filter_size = 5; // Must be odd
 		float filter_scaling = 4; // Smaller is stronger (1/x)
+
+		// When running on the CPU, the frame is filtered in parallel tiles of whole
+		// macroblocks, whose input and output fit in this many KiB of cache. Zero disables tiling.
+		uint32_t cpu_cache_budget = 512;
 	};
 
 	class DeblockingFilter final : public VideoFilter, public Configurable<DeblockingFilterSettings>
@@ -39,6 +43,10 @@ namespace lvk
 		
 		void configure(const DeblockingFilterSettings& settings) override;
 
+		bool is_stateless() const override;
+
+		std::shared_ptr<VideoFilter> clone() const override;
+
 	private:
 
         void filter(
@@ -48,15 +56,13 @@ namespace lvk
             const bool debug
         ) override;
 
+		void deblock_opencl(cv::UMat& frame, const cv::Rect& region);
+
+		void deblock_cpu(Frame& frame, const cv::Rect& region);
+
 		cv::UMat m_SmoothFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_DetectionFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_ReferenceFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_BlockMask{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_KeepBlendMap{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_DeblockBlendMap{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_BlockGrid{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-		cv::UMat m_DeblockBuffer{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY}; 
-		cv::UMat m_FloatBuffer{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_BlockWeights{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_OutputFrame;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#include "DenoisingFilter.hpp"
+
+#include "Functions/Image.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	DenoisingFilter::DenoisingFilter(const DenoisingFilterSettings& settings)
+		: VideoFilter("Denoising Filter")
+	{
+		configure(settings);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void DenoisingFilter::configure(const DenoisingFilterSettings& settings)
+	{
+		LVK_ASSERT(settings.strength >= 0.0f && settings.strength < 1.0f);
+		LVK_ASSERT(settings.change_threshold > 0.0f);
+
+		// Switching motion sources breaks the continuity of the history.
+		if(settings.motion_source != m_Settings.motion_source)
+			restart();
+
+		m_FrameTracker.configure(settings);
+
+		m_Settings = settings;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void DenoisingFilter::filter(
+		Frame&& input,
+		Frame& output,
+		Stopwatch& timer,
+		const bool debug
+	)
+	{
+		LVK_ASSERT(!input.is_empty());
+		LVK_ASSERT(input.data.channels() == 3);
+
+		// Find the motion between the last frame and this one, preferring the stabilizer's
+		// motion when available, as it has already been tracked for the frame.
+		std::optional<WarpField> motion;
+		if(m_Settings.motion_source != nullptr)
+			motion = m_Settings.motion_source->output_motion();
+		else
+		{
+			// NOTE: tracking always runs on 8-bit luma, even for high bit depth frames.
+			extract_luma(input.data, m_TrackingFrame);
+			motion = std::move(m_FrameTracker.track(m_TrackingFrame));
+		}
+
+		// NOTE: blending is only supported on 8-bit and float frames, so high
+		// bit depth frames are denoised in float, keeping their native range.
+		const int depth = input.data.depth();
+		if(depth != CV_8U) input.data.convertTo(m_FloatFrame, CV_32F);
+		const cv::UMat& frame = depth == CV_8U ? input.data : m_FloatFrame;
+
+		// Restart the history whenever the motion is lost or the frame format changes,
+		// as the previous frames can no longer be aligned with the new frame.
+		if(!motion.has_value() || m_HistoryFrame.size() != frame.size() || m_HistoryFrame.type() != frame.type())
+		{
+			frame.copyTo(m_HistoryFrame);
+			output = std::move(input);
+			return;
+		}
+
+		// Align the denoised history onto the new frame.
+		motion->apply(m_HistoryFrame, m_AlignedFrame, false);
+
+		// Each pixel is blended with the history based on how much it has changed. Pixels
+		// whose luma difference reaches the threshold are treated as real changes in the
+		// scene, such as mis-aligned or occluded content, and are passed through unblended.
+		cv::absdiff(frame, m_AlignedFrame, m_DifferenceFrame);
+		cv::extractChannel(m_DifferenceFrame, m_DifferenceLuma, 0);
+
+		double luma_unit = 1.0;
+		if(depth == CV_16U) luma_unit = 257.0;
+		else if(depth == CV_16F) luma_unit = 1.0 / 255.0;
+
+		const double threshold = m_Settings.change_threshold * luma_unit;
+		m_DifferenceLuma.convertTo(m_HistoryWeights, CV_32F, -m_Settings.strength / threshold, m_Settings.strength);
+		cv::threshold(m_HistoryWeights, m_HistoryWeights, 0.0, 0.0, cv::THRESH_TOZERO);
+		cv::subtract(cv::Scalar::all(1.0), m_HistoryWeights, m_FrameWeights);
+
+		// NOTE: the blended frame becomes the history for the next frame.
+		cv::blendLinear(m_AlignedFrame, frame, m_HistoryWeights, m_FrameWeights, m_HistoryFrame);
+		m_HistoryFrame.convertTo(input.data, depth);
+
+		output = std::move(input);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void DenoisingFilter::restart()
+	{
+		m_FrameTracker.restart();
+		m_HistoryFrame.release();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,76 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "VideoFilter.hpp"
+#include "StabilizationFilter.hpp"
+#include "Vision/FrameTracker.hpp"
+#include "Utility/Configurable.hpp"
+
+namespace lvk
+{
+
+	struct DenoisingFilterSettings : public FrameTrackerSettings
+	{
+		// Weight of the motion compensated history blended into each frame.
+		float strength = 0.6f; // Must be within [0, 1)
+
+		// Luma difference (in 8-bit units) at which a pixel is considered to
+		// have changed, rather than being noise, and is no longer blended.
+		float change_threshold = 20.0f; // Must be greater than 0
+
+		// When given, the motion of the stabilizer's output is re-used instead of tracking
+		// the frames again. The filter must then directly follow the stabilizer.
+		std::shared_ptr<StabilizationFilter> motion_source = nullptr;
+	};
+
+	class DenoisingFilter final : public VideoFilter, public Configurable<DenoisingFilterSettings>
+	{
+	public:
+
+		explicit DenoisingFilter(const DenoisingFilterSettings& settings = {});
+
+		void configure(const DenoisingFilterSettings& settings) override;
+
+		void restart();
+
+	private:
+
+        void filter(
+            Frame&& input,
+            Frame& output,
+            Stopwatch& timer,
+            const bool debug
+        ) override;
+
+	private:
+		FrameTracker m_FrameTracker;
+		cv::UMat m_TrackingFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+
+		cv::UMat m_HistoryFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_AlignedFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_FloatFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_DifferenceFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_DifferenceLuma{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_HistoryWeights{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_FrameWeights{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+	};
+
+}
@@ -0,0 +1,152 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#include "FrameRateFilter.hpp"
+
+#include "Functions/Image.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	FrameRateFilter::FrameRateFilter(const FrameRateFilterSettings& settings)
+		: VideoFilter("Frame Rate Filter")
+	{
+		configure(settings);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void FrameRateFilter::configure(const FrameRateFilterSettings& settings)
+	{
+		LVK_ASSERT(settings.rate_multiplier > 0);
+
+		m_FrameTracker.configure(settings);
+		m_PendingFrames.clear();
+
+		m_Settings = settings;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void FrameRateFilter::filter(
+		Frame&& input,
+		Frame& output,
+		Stopwatch& timer,
+		const bool debug
+	)
+	{
+		LVK_ASSERT(!input.is_empty());
+
+		// NOTE: tracking always runs on 8-bit luma, even for high bit depth frames.
+		extract_luma(input.data, m_TrackingFrame);
+		const auto motion = m_FrameTracker.track(m_TrackingFrame);
+
+		// Keep hold of the input so the next frame can be interpolated towards it.
+		std::swap(m_PreviousFrame, m_CurrentFrame);
+		m_CurrentFrame.copy(input);
+
+		// Nothing can be interpolated without a previous frame of the same format.
+		const size_t intermediate_count = m_Settings.rate_multiplier - 1;
+		m_PendingFrames.clear();
+		if(m_PreviousFrame.is_empty() || m_PreviousFrame.size() != input.size() || m_PreviousFrame.type() != input.type())
+		{
+			output = std::move(input);
+			return;
+		}
+
+		// NOTE: timestamps can go backwards, e.g. on seeks, so the duration is clamped to zero.
+		const uint64_t frame_duration = m_CurrentFrame.timestamp > m_PreviousFrame.timestamp
+			? m_CurrentFrame.timestamp - m_PreviousFrame.timestamp : 0;
+
+		// NOTE: the outputs are shared with later stages, so each frame gets new data.
+		for(size_t i = 0; i < intermediate_count; i++)
+		{
+			const float time = static_cast<float>(i + 1) / static_cast<float>(m_Settings.rate_multiplier);
+			auto& frame = m_PendingFrames.emplace_back();
+
+			frame.timestamp = m_PreviousFrame.timestamp + static_cast<uint64_t>(
+				time * static_cast<float>(frame_duration)
+			);
+
+			// If the motion was lost, we cannot safely synthesise any new content so
+			// the intermediate frames are duplicated from the nearest input frame.
+			if(motion.has_value())
+				interpolate(*motion, time, frame.data);
+			else if(time < 0.5f)
+				frame.copy(m_PreviousFrame.data);
+			else
+				frame.copy(m_CurrentFrame.data);
+		}
+
+		// The intermediate frames are presented before the input.
+		m_PendingFrames.push_back(std::move(input));
+		output = std::move(m_PendingFrames.front());
+		m_PendingFrames.pop_front();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void FrameRateFilter::interpolate(const WarpField& motion, const float time, cv::UMat& dst)
+	{
+		// The motion maps the previous frame onto the current one, so an intermediate
+		// frame is synthesised by warping the previous frame forwards along a partial
+		// motion, and the current frame backwards along the remaining motion. The two
+		// are then blended by their distance in time to hide any occlusions.
+		(motion * time).apply(m_PreviousFrame.data, m_ForwardFrame, false);
+		(motion * (time - 1.0f)).apply(m_CurrentFrame.data, m_BackwardFrame, false);
+
+		// NOTE: half float frames are blended in float, as the arithmetic does not support them.
+		if(m_ForwardFrame.depth() == CV_16F)
+		{
+			m_ForwardFrame.convertTo(m_FloatForwardFrame, CV_32F);
+			m_BackwardFrame.convertTo(m_FloatBackwardFrame, CV_32F);
+			cv::addWeighted(m_FloatForwardFrame, 1.0 - time, m_FloatBackwardFrame, time, 0.0, m_FloatForwardFrame);
+			m_FloatForwardFrame.convertTo(dst, CV_16F);
+		}
+		else cv::addWeighted(m_ForwardFrame, 1.0 - time, m_BackwardFrame, time, 0.0, dst);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void FrameRateFilter::restart()
+	{
+		m_FrameTracker.restart();
+		m_PreviousFrame.release();
+		m_CurrentFrame.release();
+		m_PendingFrames.clear();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool FrameRateFilter::pending_output(Frame& output, const bool debug)
+	{
+		if(m_PendingFrames.empty())
+		{
+			output.release();
+			return false;
+		}
+
+		output = std::move(m_PendingFrames.front());
+		m_PendingFrames.pop_front();
+		return true;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
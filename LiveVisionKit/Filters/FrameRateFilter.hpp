@@ -0,0 +1,73 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#pragma once
+
+#include <deque>
+
+#include "VideoFilter.hpp"
+#include "Vision/FrameTracker.hpp"
+#include "Utility/Configurable.hpp"
+
+namespace lvk
+{
+
+	struct FrameRateFilterSettings : public FrameTrackerSettings
+	{
+		// Number of output frames per input frame, e.g. 2 for 30 to 60 fps.
+		uint32_t rate_multiplier = 2; // Must be greater than 0
+	};
+
+	class FrameRateFilter final : public VideoFilter, public Configurable<FrameRateFilterSettings>
+	{
+	public:
+
+		explicit FrameRateFilter(const FrameRateFilterSettings& settings = {});
+
+		void configure(const FrameRateFilterSettings& settings) override;
+
+		void restart();
+
+		// NOTE: the frames synthesised before each input are output first, with the
+		// rest of them and the input itself released as pending outputs.
+		bool pending_output(Frame& output, const bool debug = false) override;
+
+	private:
+
+        void filter(
+            Frame&& input,
+            Frame& output,
+            Stopwatch& timer,
+            const bool debug
+        ) override;
+
+		void interpolate(const WarpField& motion, const float time, cv::UMat& dst);
+
+	private:
+		FrameTracker m_FrameTracker;
+		cv::UMat m_TrackingFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+
+		Frame m_PreviousFrame, m_CurrentFrame;
+		std::deque<Frame> m_PendingFrames;
+
+		cv::UMat m_ForwardFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_BackwardFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_FloatForwardFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+		cv::UMat m_FloatBackwardFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+	};
+
+}
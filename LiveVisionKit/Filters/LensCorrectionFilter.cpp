@@ -0,0 +1,259 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#include "LensCorrectionFilter.hpp"
+
+#include <thread>
+
+#include "Directives.hpp"
+#include "Timing/Time.hpp"
+#include "Functions/Text.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	LensCorrectionFilter::LensCorrectionFilter(const LensCorrectionFilterSettings& settings)
+		: VideoFilter("Lens Correction Filter")
+	{
+		configure(settings);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void LensCorrectionFilter::configure(const LensCorrectionFilterSettings& settings)
+	{
+		LVK_ASSERT(settings.correction_resolution.width >= WarpField::MinimumSize.width);
+		LVK_ASSERT(settings.correction_resolution.height >= WarpField::MinimumSize.height);
+		LVK_ASSERT(settings.camera_parameters.camera_matrix.type() == CV_64FC1);
+		LVK_ASSERT(settings.camera_parameters.camera_matrix.size() == cv::Size(3,3));
+
+		m_Settings = settings;
+		m_FieldOutdated = true;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool LensCorrectionFilter::is_stateless() const
+	{
+		return true;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	std::shared_ptr<VideoFilter> LensCorrectionFilter::clone() const
+	{
+		return std::make_shared<LensCorrectionFilter>(m_Settings);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void LensCorrectionFilter::filter(
+		Frame&& input,
+		Frame& output,
+		Stopwatch& timer,
+		const bool debug
+	)
+	{
+		LVK_ASSERT(!input.is_empty());
+
+		if(!m_Settings.camera_parameters.distortion_coefficients.empty())
+		{
+			correction_field(input.size()).apply(input.data, m_CorrectedFrame, true);
+			std::swap(input.data, m_CorrectedFrame);
+		}
+
+		output = std::move(input);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	const WarpField& LensCorrectionFilter::correction_field(const cv::Size& frame_size)
+	{
+		LVK_ASSERT(frame_size.width > 0 && frame_size.height > 0);
+
+		if(m_FieldOutdated || m_FieldFrameSize != frame_size)
+		{
+			fit_correction_field(frame_size);
+			m_FieldFrameSize = frame_size;
+			m_FieldOutdated = false;
+		}
+
+		return m_CorrectionField;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void LensCorrectionFilter::fit_correction_field(const cv::Size& frame_size)
+	{
+		const auto& resolution = m_Settings.correction_resolution;
+		const auto& parameters = m_Settings.camera_parameters;
+
+		// Re-use the field from a previous run if we have already fitted it.
+		const auto cache_path = m_Settings.cache_fields ? field_cache_path(frame_size) : std::filesystem::path();
+		if(!cache_path.empty())
+		{
+			// NOTE: a cache which can't be read or parsed is treated as a miss.
+			cv::Mat cached_offsets;
+			try
+			{
+				if(cv::FileStorage cache_file(cache_path.string(), cv::FileStorage::READ); cache_file.isOpened())
+					cache_file["offsets"] >> cached_offsets;
+			}
+			catch(const cv::Exception&)
+			{
+				cached_offsets.release();
+			}
+
+			if(cached_offsets.size() == resolution && cached_offsets.type() == CV_32FC2)
+			{
+				m_CorrectionField.set_to(std::move(cached_offsets), true);
+				return;
+			}
+		}
+
+		cv::Rect view_region;
+		const cv::Mat optimal_camera_matrix = cv::getOptimalNewCameraMatrix(
+			parameters.camera_matrix,
+			parameters.distortion_coefficients,
+			frame_size,
+			0,
+			frame_size,
+			&view_region
+		);
+
+		// Rather than undistorting every pixel of the frame, as initUndistortRectifyMap
+		// would, only the field's nodes are undistorted. Each node position is taken
+		// back through the optimal camera to a ray, which is then projected through the
+		// original lens model to find where it lies within the distorted frame.
+		const cv::Matx33d inverse_camera = cv::Matx33d(optimal_camera_matrix).inv();
+		const cv::Size2f node_spacing(
+			static_cast<float>(frame_size.width) / static_cast<float>(resolution.width - 1),
+			static_cast<float>(frame_size.height) / static_cast<float>(resolution.height - 1)
+		);
+
+		std::vector<cv::Point2f> node_points;
+		std::vector<cv::Point3f> node_rays;
+		node_points.reserve(resolution.area());
+		node_rays.reserve(resolution.area());
+
+		for(int r = 0; r < resolution.height; r++)
+		{
+			for(int c = 0; c < resolution.width; c++)
+			{
+				const auto& point = node_points.emplace_back(
+					static_cast<float>(c) * node_spacing.width,
+					static_cast<float>(r) * node_spacing.height
+				);
+
+				const cv::Vec3d ray = inverse_camera * cv::Vec3d(point.x, point.y, 1.0);
+				node_rays.emplace_back(ray[0] / ray[2], ray[1] / ray[2], 1.0f);
+			}
+		}
+
+		std::vector<cv::Point2f> distorted_points;
+		cv::projectPoints(
+			node_rays,
+			cv::Vec3d::zeros(),
+			cv::Vec3d::zeros(),
+			parameters.camera_matrix,
+			parameters.distortion_coefficients,
+			distorted_points
+		);
+
+		cv::Mat offsets(resolution, CV_32FC2);
+		for(int i = 0; i < resolution.area(); i++)
+			offsets.at<cv::Point2f>(i) = distorted_points[i] - node_points[i];
+
+		m_CorrectionField.set_to(std::move(offsets), true);
+		m_CorrectionField.crop_in(view_region, frame_size);
+
+		// NOTE: a failure to cache the field is not an error, it will just be re-fitted.
+		if(!cache_path.empty())
+		{
+			std::error_code error;
+			std::filesystem::create_directories(cache_path.parent_path(), error);
+
+			// Write to a unique temporary file and move it into place afterwards, so that
+			// parallel filters never get to read a partially written field. The extension
+			// is kept last, as the file storage uses it to determine the format.
+			auto temp_path = cache_path;
+			temp_path.replace_extension(cv::format(
+				".%llx-%zx.tmp%s",
+				static_cast<unsigned long long>(Time::Now().nanoseconds()),
+				std::hash<std::thread::id>{}(std::this_thread::get_id()),
+				cache_path.extension().string().c_str()
+			));
+
+			bool written = false;
+			try
+			{
+				cv::FileStorage cache_file(temp_path.string(), cv::FileStorage::WRITE);
+				if(cache_file.isOpened())
+				{
+					cache_file << "offsets" << m_CorrectionField.offsets();
+					cache_file.release();
+					written = true;
+				}
+			}
+			catch(const cv::Exception&) {}
+
+			if(written)
+				std::filesystem::rename(temp_path, cache_path, error);
+
+			if(!written || error)
+				std::filesystem::remove(temp_path, error);
+		}
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	std::filesystem::path LensCorrectionFilter::field_cache_path(const cv::Size& frame_size) const
+	{
+		auto directory = m_Settings.cache_directory;
+		if(directory.empty())
+		{
+			std::error_code error;
+			const auto temp_directory = std::filesystem::temp_directory_path(error);
+			if(error) return {};
+
+			directory = temp_directory / "lvk-lens-cache";
+		}
+
+		// The field is only valid for the exact profile, frame size and field resolution
+		// it was fitted with, so the cache key is a hash of all of these properties.
+		const auto& parameters = m_Settings.camera_parameters;
+		std::string key = cv::format(
+			"%dx%d|%dx%d",
+			frame_size.width, frame_size.height,
+			m_Settings.correction_resolution.width, m_Settings.correction_resolution.height
+		);
+
+		for(const auto element : cv::Matx33d(parameters.camera_matrix).val)
+			key += cv::format("|%.17g", element);
+
+		for(const auto coefficient : parameters.distortion_coefficients)
+			key += cv::format("|%.17g", coefficient);
+
+		const auto key_hash = static_cast<unsigned long long>(fnv1a_hash(key));
+		return directory / cv::format("lens-%016llx.yml", key_hash);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,78 @@
+//    *************************** LiveVisionKit ****************************
+//    Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+// 	  **********************************************************************
+
+#pragma once
+
+#include <filesystem>
+
+#include "VideoFilter.hpp"
+#include "Math/WarpField.hpp"
+#include "Vision/CameraCalibrator.hpp"
+#include "Utility/Configurable.hpp"
+
+namespace lvk
+{
+
+	struct LensCorrectionFilterSettings
+	{
+		// NOTE: no correction is applied until distortion coefficients are given.
+		CameraParameters camera_parameters;
+
+		// Resolution of the field fitted to the distortion model.
+		cv::Size correction_resolution = {32, 18};
+
+		// Fitted fields are cached on disk per profile and resolution. An empty
+		// directory uses a sub-directory of the system's temporary directory.
+		bool cache_fields = true;
+		std::filesystem::path cache_directory;
+	};
+
+	class LensCorrectionFilter final : public VideoFilter, public Configurable<LensCorrectionFilterSettings>
+	{
+	public:
+
+		explicit LensCorrectionFilter(const LensCorrectionFilterSettings& settings = {});
+
+		void configure(const LensCorrectionFilterSettings& settings) override;
+
+		bool is_stateless() const override;
+
+		std::shared_ptr<VideoFilter> clone() const override;
+
+		const WarpField& correction_field(const cv::Size& frame_size);
+
+	private:
+
+        void filter(
+            Frame&& input,
+            Frame& output,
+            Stopwatch& timer,
+            const bool debug
+        ) override;
+
+		void fit_correction_field(const cv::Size& frame_size);
+
+		std::filesystem::path field_cache_path(const cv::Size& frame_size) const;
+
+	private:
+		bool m_FieldOutdated = true;
+		cv::Size m_FieldFrameSize{0, 0};
+		WarpField m_CorrectionField{WarpField::MinimumSize};
+		cv::UMat m_CorrectedFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+	};
+
+}
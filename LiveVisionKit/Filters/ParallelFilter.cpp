@@ -0,0 +1,255 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "ParallelFilter.hpp"
+
+#include <algorithm>
+#include <opencv2/core/ocl.hpp>
+
+#include "Timing/Tracing.hpp"
+#include "Functions/OpenCL/Kernels.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ParallelFilter::ParallelFilter(const ParallelFilterSettings& settings)
+        : VideoFilter("Parallel Filter")
+    {
+        configure(settings);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ParallelFilter::ParallelFilter(const std::shared_ptr<VideoFilter>& filter, const size_t thread_count)
+        : ParallelFilter(ParallelFilterSettings{.filter = filter, .thread_count = thread_count})
+    {}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ParallelFilter::~ParallelFilter()
+    {
+        stop_workers();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::configure(const ParallelFilterSettings& settings)
+    {
+        LVK_ASSERT(settings.filter == nullptr || settings.filter->is_stateless());
+
+        stop_workers();
+        m_Settings = settings;
+        start_workers();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::filter(
+        Frame&& input,
+        Frame& output,
+        Stopwatch& timer,
+        const bool debug
+    )
+    {
+        LVK_ASSERT(!input.is_empty());
+
+        // With no filter we act as an identity filter.
+        if(m_Workers.empty())
+        {
+            output = std::move(input);
+            return;
+        }
+
+        // Workers are given frames round-robin, so the next worker always holds the oldest
+        // frame in flight. Collecting its output before handing it the new frame releases
+        // all frames in their original order, without needing any explicit reordering.
+        auto& worker = *m_Workers[m_NextWorker];
+        m_NextWorker = (m_NextWorker + 1) % m_Workers.size();
+
+        if(m_FramesInFlight == m_Workers.size())
+            collect_output(worker, output);
+        else
+        {
+            m_FramesInFlight++;
+            output.release();
+        }
+
+        // The input may still be in flight on our queue, which the worker doesn't share. So
+        // the worker waits on a marker queued behind it, or we must finish the queue here.
+        auto input_marker = ocl::queue_marker();
+        if(input_marker == nullptr && cv::ocl::useOpenCL())
+            cv::ocl::finish();
+
+        std::unique_lock<std::mutex> worker_lock(worker.mutex);
+        worker.input = std::move(input);
+        worker.input_marker = std::move(input_marker);
+        worker.debug = debug;
+        worker.has_input = true;
+        worker.flag.notify_all();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool ParallelFilter::flush(Frame& output, const bool debug)
+    {
+        if(m_FramesInFlight == 0)
+        {
+            output.release();
+            return false;
+        }
+
+        // The oldest frame in flight is held by the worker furthest behind the next one.
+        const size_t oldest_worker = (m_NextWorker + m_Workers.size() - m_FramesInFlight) % m_Workers.size();
+        collect_output(*m_Workers[oldest_worker], output);
+        m_FramesInFlight--;
+
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::collect_output(Worker& worker, Frame& output)
+    {
+        std::unique_lock<std::mutex> worker_lock(worker.mutex);
+        while(!worker.has_output)
+            worker.flag.wait(worker_lock);
+
+        output = std::move(worker.output);
+        worker.has_output = false;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const Stopwatch& ParallelFilter::timings() const
+    {
+        return m_Settings.filter != nullptr ? m_Settings.filter->timings() : VideoFilter::timings();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const std::string& ParallelFilter::alias() const
+    {
+        return m_Settings.filter != nullptr ? m_Settings.filter->alias() : VideoFilter::alias();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::restart()
+    {
+        // Restarting the workers discards all the frames in flight.
+        stop_workers();
+        start_workers();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t ParallelFilter::frame_delay() const
+    {
+        return m_Workers.empty() ? 0 : m_Workers.size() - 1;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::start_workers()
+    {
+        m_NextWorker = 0;
+        m_FramesInFlight = 0;
+
+        if(m_Settings.filter == nullptr)
+            return;
+
+        size_t thread_count = m_Settings.thread_count;
+        if(thread_count == 0)
+            thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+        // The original filter is used by the first worker, the rest get clones.
+        for(size_t i = 0; i < thread_count; i++)
+        {
+            auto& worker = m_Workers.emplace_back(std::make_unique<Worker>());
+            worker->filter = (i == 0) ? m_Settings.filter : m_Settings.filter->clone();
+            LVK_ASSERT(worker->filter != nullptr);
+
+            worker->thread = std::thread(&ParallelFilter::run_worker, std::ref(*worker));
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::stop_workers()
+    {
+        for(auto& worker : m_Workers)
+        {
+            {
+                std::unique_lock<std::mutex> worker_lock(worker->mutex);
+                worker->terminate = true;
+                worker->flag.notify_all();
+            }
+            worker->thread.join();
+        }
+
+        m_Workers.clear();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void ParallelFilter::run_worker(Worker& worker)
+    {
+        trace::name_thread("Parallel Worker");
+
+        Frame input, output;
+        std::shared_ptr<std::atomic<uint64_t>> input_marker;
+        while(true)
+        {
+            bool debug = false;
+
+            // Wait for the next frame to filter
+            {
+                std::unique_lock<std::mutex> worker_lock(worker.mutex);
+                while(!worker.has_input && !worker.terminate)
+                    worker.flag.wait(worker_lock);
+
+                if(worker.terminate)
+                    return;
+
+                input = std::move(worker.input);
+                input_marker = std::move(worker.input_marker);
+                debug = worker.debug;
+                worker.has_input = false;
+            }
+
+            ocl::wait_for_marker(input_marker);
+            worker.filter->process(std::move(input), output, debug);
+
+            // The output is handed to another thread, so its queued work must finish first.
+            if(cv::ocl::useOpenCL())
+                cv::ocl::finish();
+
+            // Hand back the filtered frame
+            {
+                std::unique_lock<std::mutex> worker_lock(worker.mutex);
+                worker.output = std::move(output);
+                worker.has_output = true;
+                worker.flag.notify_all();
+            }
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,104 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+#include "VideoFilter.hpp"
+#include "Utility/Configurable.hpp"
+
+namespace lvk
+{
+
+    struct ParallelFilterSettings
+    {
+        // NOTE: the filter must be stateless.
+        std::shared_ptr<VideoFilter> filter;
+
+        // NOTE: zero uses all the available hardware threads.
+        size_t thread_count = 0;
+    };
+
+    // Runs clones of a stateless filter on multiple threads, so that consecutive
+    // frames are filtered concurrently. The frames are released in their input
+    // order, with a delay of one frame per thread less one. The frames still in
+    // flight at the end of the stream are released by flushing the filter.
+    class ParallelFilter final : public VideoFilter, public Configurable<ParallelFilterSettings>
+    {
+    public:
+
+        explicit ParallelFilter(const ParallelFilterSettings& settings = {});
+
+        explicit ParallelFilter(const std::shared_ptr<VideoFilter>& filter, const size_t thread_count = 0);
+
+        ~ParallelFilter() override;
+
+        void configure(const ParallelFilterSettings& settings) override;
+
+        void restart();
+
+        size_t frame_delay() const;
+
+        bool flush(Frame& output, const bool debug = false) override;
+
+        // NOTE: the timings and alias are forwarded from the wrapped filter.
+        const Stopwatch& timings() const override;
+
+        const std::string& alias() const override;
+
+    private:
+
+        struct Worker
+        {
+            std::shared_ptr<VideoFilter> filter;
+
+            std::mutex mutex;
+            std::condition_variable flag;
+            Frame input, output;
+            std::shared_ptr<std::atomic<uint64_t>> input_marker;
+            bool has_input = false, has_output = false, terminate = false;
+            bool debug = false;
+
+            std::thread thread;
+        };
+
+        void filter(
+            Frame&& input,
+            Frame& output,
+            Stopwatch& timer,
+            const bool debug
+        ) override;
+
+        void start_workers();
+
+        void stop_workers();
+
+        static void collect_output(Worker& worker, Frame& output);
+
+        static void run_worker(Worker& worker);
+
+    private:
+        std::vector<std::unique_ptr<Worker>> m_Workers;
+        size_t m_NextWorker = 0, m_FramesInFlight = 0;
+    };
+
+}
@@ -43,10 +43,33 @@ namespace lvk
         LVK_ASSERT_01(settings.sharpness);
         LVK_ASSERT(settings.output_size.width > 0);
         LVK_ASSERT(settings.output_size.height > 0);
+        LVK_ASSERT(!settings.input_size.has_value() || !is_mixed_scaling(*settings.input_size, settings.output_size));
 
         m_Settings = settings;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool ScalingFilter::is_mixed_scaling(const cv::Size& input_size, const cv::Size& output_size)
+    {
+        return (output_size.width < input_size.width && output_size.height > input_size.height)
+            || (output_size.width > input_size.width && output_size.height < input_size.height);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool ScalingFilter::is_stateless() const
+    {
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<VideoFilter> ScalingFilter::clone() const
+    {
+        return std::make_shared<ScalingFilter>(m_Settings);
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void ScalingFilter::filter(
@@ -58,8 +81,32 @@ namespace lvk
     {
         LVK_ASSERT(!input.is_empty());
 
-        lvk::upscale(input.data, output.data, m_Settings.output_size, m_Settings.yuv_input);
-        lvk::sharpen(output.data, output.data, m_Settings.sharpness);
+        const cv::Size& size = m_Settings.output_size;
+        if(size.width <= input.data.cols && size.height <= input.data.rows && size != input.data.size())
+        {
+            // NOTE: downscaled frames are not sharpened, as area
+            // interpolation already retains most of the detail.
+            lvk::downscale(input.data, output.data, size);
+        }
+        else if(is_mixed_scaling(input.data.size(), size))
+        {
+            // Inputs of an unknown size may still need mixed scaling, so
+            // the shrinking axis is downscaled before upscaling the other.
+            const cv::Size shrunk_size(std::min(size.width, input.data.cols), std::min(size.height, input.data.rows));
+            lvk::downscale(input.data, m_ShrinkBuffer, shrunk_size);
+            lvk::upscale_sharpen(m_ShrinkBuffer, output.data, size, m_Settings.sharpness, m_Settings.yuv_input);
+        }
+        else
+        {
+            // NOTE: equal sizes are only sharpened.
+            lvk::upscale_sharpen(
+                input.data,
+                output.data,
+                size,
+                m_Settings.sharpness,
+                m_Settings.yuv_input
+            );
+        }
         output.timestamp = input.timestamp;
     }
 
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "VideoFilter.hpp"
 #include "Utility/Configurable.hpp"
 
@@ -28,6 +30,9 @@ namespace lvk
         cv::Size output_size = {1920, 1080};
         float sharpness = 0.8f;
         bool yuv_input = true;
+
+        // NOTE: if known, scaling which shrinks one axis while growing the other is rejected.
+        std::optional<cv::Size> input_size;
     };
 
     class ScalingFilter final : public VideoFilter, public Configurable<ScalingFilterSettings>
@@ -40,6 +45,10 @@ namespace lvk
 
         void configure(const ScalingFilterSettings& settings) override;
 
+        bool is_stateless() const override;
+
+        std::shared_ptr<VideoFilter> clone() const override;
+
     private:
 
         void filter(
@@ -49,6 +58,10 @@ namespace lvk
             const bool debug
         ) override;
 
+        static bool is_mixed_scaling(const cv::Size& input_size, const cv::Size& output_size);
+
+    private:
+        cv::UMat m_ShrinkBuffer{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
     };
 
 }
@@ -19,6 +19,7 @@
 
 #include "Directives.hpp"
 #include "Functions/Drawing.hpp"
+#include "Functions/Image.hpp"
 #include "Functions/Extensions.hpp"
 
 namespace lvk
@@ -41,9 +42,8 @@ namespace lvk
         if(m_Settings.stabilize_output && !settings.stabilize_output)
             reset_context();
 
-        m_NullMotion.resize(settings.motion_resolution);
-
         m_FrameTracker.configure(settings);
+        m_NullMotion.resize(m_FrameTracker.motion_resolution());
         m_Stabilizer.configure(settings);
 
         m_Settings = settings;
@@ -65,10 +65,12 @@ namespace lvk
         if(m_Settings.stabilize_output)
         {
             // Track and stabilize the frame
-            cv::extractChannel(input.data, m_TrackingFrame, 0);
+            // NOTE: tracking always runs on 8-bit luma, even for high bit depth frames.
+            extract_luma(input.data, m_TrackingFrame);
             motion = std::move(m_FrameTracker.track(m_TrackingFrame));
 
-            if(debug)
+            // NOTE: the debug drawings only support 8-bit frames.
+            if(debug && input.data.depth() == CV_8U)
             {
                 // If we're in debug, draw the motion trackers,
                 // ensuring we do not time the debug rendering.
@@ -132,5 +134,12 @@ namespace lvk
 		return m_Stabilizer.stable_region();
 	}
 
+//---------------------------------------------------------------------------------------------------------------------
+
+	const WarpField& StabilizationFilter::output_motion() const
+	{
+		return m_Stabilizer.output_motion();
+	}
+
 //---------------------------------------------------------------------------------------------------------------------
 }
\ No newline at end of file
@@ -51,6 +51,8 @@ namespace lvk
 
 		const cv::Rect& crop_region() const;
 
+		const WarpField& output_motion() const;
+
 	private:
 
         void filter(
@@ -25,6 +25,7 @@
 #include <mutex>
 
 #include "Timing/TickTimer.hpp"
+#include "Timing/Tracing.hpp"
 
 namespace lvk
 {
@@ -54,9 +55,15 @@ namespace lvk
         const bool debug
     )
     {
-        m_FrameTimer.sync_gpu(debug).start();
+        LVK_TRACE(m_Alias);
+
+        // The GPU work is only timed when debugging or when GPU timing was requested.
+        // Queue markers time it without stalling, otherwise the queue is drained.
+        const bool sync_gpu = debug || m_GPUTiming;
+
+        m_FrameTimer.sync_gpu(sync_gpu).start();
         filter(std::move(input), output, m_FrameTimer, debug);
-        m_FrameTimer.sync_gpu(debug).stop();
+        m_FrameTimer.sync_gpu(sync_gpu).stop();
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -69,6 +76,30 @@ namespace lvk
     {
         LVK_ASSERT(input_stream.isOpened());
 
+        process(
+            [&](Frame& frame)
+            {
+                if(!input_stream.read(frame.data))
+                    return false;
+
+                // Set frame timestamp if supported, otherwise set it to zero.
+                const auto stream_position = std::max(0.0, input_stream.get(cv::CAP_PROP_POS_MSEC));
+                frame.timestamp = static_cast<uint64_t>(Time::Milliseconds(stream_position).nanoseconds());
+                return true;
+            },
+            callback,
+            debug
+        );
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void VideoFilter::process(
+        const std::function<bool(Frame&)>& input_source,
+        const std::function<bool(VideoFilter&, Frame&)>& callback,
+        const bool debug
+    )
+    {
         const size_t max_buffer_frames = 15;
 
         std::mutex input_mutex, output_mutex;
@@ -79,15 +110,13 @@ namespace lvk
         std::atomic<bool> input_finished = false, filter_finished = false, terminate_input = false;
 
         // Input Processor
-        // This reads frames from the input stream and passes them off for filtering.
+        // This reads frames from the input source and passes them off for filtering.
         auto input_thread = std::thread([&](){
+            trace::name_thread("Input Processor");
+
             Frame read_frame;
-            while(input_stream.read(read_frame.data) && !terminate_input)
+            while(!terminate_input && input_source(read_frame))
             {
-                // Set frame timestamp if supported, otherwise set it to zero.
-                const auto stream_position = std::max(0.0, input_stream.get(cv::CAP_PROP_POS_MSEC));
-                read_frame.timestamp = static_cast<uint64_t>(Time::Milliseconds(stream_position).nanoseconds());
-
                 // Push new frame onto the input queue
                 {
                     std::unique_lock<std::mutex> queue_lock(input_mutex);
@@ -109,29 +138,58 @@ namespace lvk
         // Filter Processor
         // This grabs frames delivered by the input processor, filters them, and passes them off for output.
         auto filter_thread = std::thread([&](){
+            trace::name_thread("Filter Processor");
+
             Frame input_frame, filtered_frame;
+            const auto push_output = [&](Frame& frame)
+            {
+                std::unique_lock<std::mutex> queue_lock(output_mutex);
+
+                // If the output queue is saturated, wait until a frame is consumed
+                while(output_queue.size() >= max_buffer_frames)
+                    output_consume_flag.wait(queue_lock);
+
+                output_queue.push(std::move(frame));
+                if(output_queue.size() == 1)
+                    output_available_flag.notify_one();
+            };
+
             while(true)
             {
                 // Pop a frame from the input queue
+                bool end_of_stream = false;
                 {
                     std::unique_lock<std::mutex> queue_lock(input_mutex);
-                    while(input_queue.empty())
+                    while(input_queue.empty() && !input_finished)
+                        input_available_flag.wait(queue_lock);
+
+                    // If there are no new frames incoming, then we have filtered everything
+                    if(input_queue.empty())
+                        end_of_stream = true;
+                    else
                     {
-                        // If there are no new frames incoming, then we have filtered everything
-                        if(input_finished)
-                        {
-                            filter_finished = true;
-                            output_available_flag.notify_one();
-                            return;
-                        }
+                        input_frame = std::move(input_queue.front());
+                        input_queue.pop();
 
-                        input_available_flag.wait(queue_lock);
+                        input_consume_flag.notify_one();
                     }
+                }
 
-                    input_frame = std::move(input_queue.front());
-                    input_queue.pop();
+                if(end_of_stream)
+                {
+                    // Release any frames still held by the filter, unless we were terminated.
+                    while(!terminate_input && flush(filtered_frame, debug))
+                    {
+                        if(!filtered_frame.is_empty())
+                            push_output(filtered_frame);
 
-                    input_consume_flag.notify_one();
+                        while(pending_output(filtered_frame, debug))
+                            push_output(filtered_frame);
+                    }
+
+                    filter_finished = true;
+                    output_available_flag.notify_one();
+                    return;
                 }
 
                 // Process the frame
@@ -139,24 +197,18 @@ namespace lvk
                 if(filtered_frame.is_empty())
                     continue;
 
-                // Push processed frame onto the output queue
-                {
-                    std::unique_lock<std::mutex> queue_lock(output_mutex);
-
-                    // If the output queue is saturated, wait until a frame is consumed
-                    while(output_queue.size() >= max_buffer_frames)
-                        output_consume_flag.wait(queue_lock);
-
-                    output_queue.push(std::move(filtered_frame));
-                    if(output_queue.size() == 1)
-                        output_available_flag.notify_one();
-                }
+                // Push processed frame onto the output queue, followed by any extra frames.
+                push_output(filtered_frame);
+                while(pending_output(filtered_frame, debug))
+                    push_output(filtered_frame);
             }
         });
 
 
         // Output Processor
         // This grabs filtered frames delivered by the filter processor and sends them to the user callback.
+        trace::name_thread("Output Processor");
+
         Frame output_frame;
         while(true)
         {
@@ -249,6 +301,38 @@ namespace lvk
         }, debug);
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool VideoFilter::is_stateless() const
+    {
+        return false;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<VideoFilter> VideoFilter::clone() const
+    {
+        return nullptr;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool VideoFilter::pending_output(Frame& output, const bool debug)
+    {
+        // Filters output one frame per input by default.
+        output.release();
+        return false;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool VideoFilter::flush(Frame& output, const bool debug)
+    {
+        // Filters hold back no frames by default.
+        output.release();
+        return false;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void VideoFilter::set_timing_samples(const uint32_t samples)
@@ -256,6 +340,13 @@ namespace lvk
         m_FrameTimer = Stopwatch(samples);
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    void VideoFilter::set_gpu_timing(const bool enabled)
+    {
+        m_GPUTiming = enabled;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     const Stopwatch& VideoFilter::timings() const
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <opencv2/opencv.hpp>
 #include <opencv2/videoio.hpp>
 
@@ -55,6 +56,13 @@ namespace lvk
             const bool debug = false
         );
 
+        // NOTE: the input source returns false once it has no more frames.
+        void process(
+            const std::function<bool(Frame&)>& input_source,
+            const std::function<bool(VideoFilter&, Frame&)>& callback,
+            const bool debug = false
+        );
+
         void render(
             const Frame& input,
             bool debug = false
@@ -66,11 +74,30 @@ namespace lvk
             const bool debug = false
         );
 
+        // NOTE: stateless filters keep no temporal state between frames, so
+        // their clones can safely process different frames concurrently.
+        virtual bool is_stateless() const;
+
+        // NOTE: returns nullptr if the filter does not support cloning.
+        virtual std::shared_ptr<VideoFilter> clone() const;
+
+        // NOTE: releases the extra frames output by filters which produce several
+        // frames per input, one per call, and returns false once there are none
+        // left. These must be collected after every processed frame, in order.
+        virtual bool pending_output(Frame& output, const bool debug = false);
+
+        // NOTE: releases the frames still held by the filter at the end of the
+        // stream, one per call, and returns false once there are none left.
+        virtual bool flush(Frame& output, const bool debug = false);
+
         void set_timing_samples(const uint32_t samples);
 
-        const Stopwatch& timings() const;
+        // NOTE: GPU timing queues markers around every frame, so it is opt-in.
+        void set_gpu_timing(const bool enabled);
+
+        virtual const Stopwatch& timings() const;
 
-		const std::string& alias() const;
+		virtual const std::string& alias() const;
 
     protected:
 
@@ -84,6 +111,7 @@ namespace lvk
     private:
         Frame m_FrameBuffer;
         Stopwatch m_FrameTimer;
+        bool m_GPUTiming = false;
 		const std::string m_Alias;
 	};
 
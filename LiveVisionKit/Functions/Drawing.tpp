@@ -51,10 +51,8 @@ namespace lvk
         LVK_ASSERT(thickness >= 1);
         LVK_ASSERT(!dst.empty());
 
-        // Create FSR RCAS kernel
         static auto program = ocl::load_program("draw", ocl::src::drawing_source);
-        thread_local cv::ocl::Kernel kernel("grid", program);
-        LVK_ASSERT(!program.empty() && !kernel.empty());
+        LVK_ASSERT(!program.empty());
 
         // Find cell size of the grid
         const float cell_width = static_cast<float>(dst.cols) / static_cast<float>(grid.width);
@@ -64,8 +62,10 @@ namespace lvk
         size_t global_work_size[3], local_work_size[3];
         ocl::optimal_groups(dst, global_work_size, local_work_size);
 
-        // Run the kernel in async mode.
-        kernel.args(
+        ocl::dispatch(
+            program,
+            "grid",
+            2, global_work_size, local_work_size,
             cv::ocl::KernelArg::WriteOnly(dst),
             cell_width, cell_height, thickness,
             cv::Vec4b{
@@ -74,10 +74,7 @@ namespace lvk
                 static_cast<uint8_t>(color[2]),
                 0 // NOTE: 4th component is unused
             }
-        ).run_(2, global_work_size, local_work_size, false);
-
-        // Create next kernel while the last one runs.
-        kernel.create("grid", program);
+        );
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -99,10 +96,8 @@ namespace lvk
         if(points.empty())
             return;
 
-        // Create FSR RCAS kernel
         static auto program = ocl::load_program("draw", ocl::src::drawing_source);
-        thread_local cv::ocl::Kernel kernel("points", program);
-        LVK_ASSERT(!program.empty() && !kernel.empty());
+        LVK_ASSERT(!program.empty());
 
         // Upload and scale points to 32bit int image coords.
         thread_local cv::UMat staging_buffer, points_buffer;
@@ -113,8 +108,10 @@ namespace lvk
         size_t global_work_size[3], local_work_size[3];
         ocl::optimal_groups(points_buffer, global_work_size, local_work_size);
 
-        // Run the kernel in async mode.
-        kernel.args(
+        ocl::dispatch(
+            program,
+            "points",
+            1, global_work_size, local_work_size,
             cv::ocl::KernelArg::ReadOnly(points_buffer),
             cv::ocl::KernelArg::WriteOnly(dst),
             (point_size + 1) / 2,
@@ -124,10 +121,7 @@ namespace lvk
                 static_cast<uint8_t>(color[2]),
                 0 // NOTE: 4th component is unused
             }
-        ).run_(1, global_work_size, local_work_size, false);
-
-        // Create next kernel while the last one runs.
-        kernel.create("points", program);
+        );
     }
 
 //---------------------------------------------------------------------------------------------------------------------
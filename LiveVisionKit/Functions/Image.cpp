@@ -20,9 +20,50 @@
 #include "OpenCL/Kernels.hpp"
 #include "Directives.hpp"
 
+#include <numeric>
+#include <algorithm>
+
 namespace lvk
 {
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    // FSR programs are built for each supported pixel depth, and have
+    // yuv and bgr versions for their different luma calculations.
+    static const cv::ocl::Program& fsr_program(const int depth, const bool yuv)
+    {
+        static const auto load = [](const char* flags)
+        {
+            auto program = ocl::load_program("fsr", ocl::src::fsr_source, flags);
+            LVK_ASSERT(!program.empty());
+            return program;
+        };
+
+        switch(depth)
+        {
+            case CV_16U:
+            {
+                static auto program_yuv = load("-D DEPTH_16U -D YUV_INPUT");
+                static auto program_bgr = load("-D DEPTH_16U");
+                return yuv ? program_yuv : program_bgr;
+            }
+            case CV_16F:
+            {
+                static auto program_yuv = load("-D DEPTH_16F -D YUV_INPUT");
+                static auto program_bgr = load("-D DEPTH_16F");
+                return yuv ? program_yuv : program_bgr;
+            }
+            default:
+            {
+                LVK_ASSERT(depth == CV_8U && "Unsupported pixel depth");
+
+                static auto program_yuv = load("-D YUV_INPUT");
+                static auto program_bgr = load("");
+                return yuv ? program_yuv : program_bgr;
+            }
+        }
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     // TODO: properly handle bounds to avoid loss of content?
@@ -30,26 +71,15 @@ namespace lvk
     {
         LVK_ASSERT(offset_map.type() == CV_32FC2);
         LVK_ASSERT(src.cols > 0 && src.rows > 0);
-        LVK_ASSERT(src.type() == CV_8UC3);
+        LVK_ASSERT(src.channels() == 3);
         LVK_ASSERT(!offset_map.empty());
         LVK_ASSERT(!src.empty());
 
-        // FSR program has yuv and bgr versions for different luma calculations.
-        static auto program_yuv = ocl::load_program("fsr", ocl::src::fsr_source, "-D YUV_INPUT");
-        static auto program_bgr = ocl::load_program("fsr", ocl::src::fsr_source);
-        LVK_ASSERT(!program_yuv.empty() && !program_bgr.empty());
-
-        // Create FSR EASU kernel
-        thread_local cv::ocl::Kernel kernel;
-        thread_local bool kernel_is_yuv = yuv;
-        if(kernel.empty() || kernel_is_yuv != yuv)
-        {
-            kernel.create("easu_remap", yuv ? program_yuv : program_bgr);
-        }
+        const auto& program = fsr_program(src.depth(), yuv);
 
         // Allocate the output based on the size of the offset map. This allows
         // an ROI of the source to be remapped and scaling operations to occur.
-        dst.create(offset_map.size(), CV_8UC3);
+        dst.create(offset_map.size(), src.type());
 
         // We need to account for the ROI offset in the map
         // when we create the output coordinates in the kernel.
@@ -60,17 +90,15 @@ namespace lvk
         size_t global_work_size[3], local_work_size[3];
         ocl::optimal_groups(dst, global_work_size, local_work_size);
 
-        // Run the kernel in async mode.
-        kernel.args(
+        ocl::dispatch(
+            program,
+            "easu_remap",
+            2, global_work_size, local_work_size,
             cv::ocl::KernelArg::ReadOnly(src),
             cv::ocl::KernelArg::WriteOnlyNoSize(dst),
             cv::Vec4i{dst_offset.x, dst_offset.y, dst.cols, dst.rows},
             cv::ocl::KernelArg::ReadOnlyNoSize(offset_map)
-        ).run_(2, global_work_size, local_work_size, false);
-
-        // Create next kernel while the last one runs.
-        kernel.create("easu_remap", yuv ? program_yuv : program_bgr);
-        kernel_is_yuv = yuv;
+        );
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -79,7 +107,7 @@ namespace lvk
     {
         LVK_ASSERT(size.width >= src.cols && size.height >= src.rows);
         LVK_ASSERT(src.cols > 0 && src.rows > 0);
-        LVK_ASSERT(src.type() == CV_8UC3);
+        LVK_ASSERT(src.channels() == 3);
         LVK_ASSERT(!src.empty());
 
         if(size == src.size())
@@ -88,39 +116,87 @@ namespace lvk
             return;
         }
 
-        // FSR program has yuv and bgr versions for different luma calculations.
-        static auto program_yuv = ocl::load_program("fsr", ocl::src::fsr_source, "-D YUV_INPUT");
-        static auto program_bgr = ocl::load_program("fsr", ocl::src::fsr_source);
-        LVK_ASSERT(!program_yuv.empty() && !program_bgr.empty());
-
-        // Create FSR EASU kernel
-        thread_local cv::ocl::Kernel kernel;
-        thread_local bool kernel_is_yuv = yuv;
-        if(kernel.empty() || kernel_is_yuv != yuv)
-        {
-            kernel.create("easu_scale", yuv ? program_yuv : program_bgr);
-        }
+        const auto& program = fsr_program(src.depth(), yuv);
 
         // Allocate the output.
-        dst.create(size, CV_8UC3);
+        dst.create(size, src.type());
 
         // Find optimal work sizes for the 2D dst buffer.
         size_t global_work_size[3], local_work_size[3];
         ocl::optimal_groups(dst, global_work_size, local_work_size);
 
-        // Run the kernel in async mode.
-        kernel.args(
+        ocl::dispatch(
+            program,
+            "easu_scale",
+            2, global_work_size, local_work_size,
             cv::ocl::KernelArg::ReadOnly(src),
             cv::ocl::KernelArg::WriteOnly(dst),
             cv::Vec2f{
                 static_cast<float>(src.cols) / static_cast<float>(dst.cols),
                 static_cast<float>(src.rows) / static_cast<float>(dst.rows)
             }
-        ).run_(2, global_work_size, local_work_size, false);
+        );
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void downscale(const cv::UMat& src, cv::UMat& dst, const cv::Size& size)
+    {
+        LVK_ASSERT(size.width <= src.cols && size.height <= src.rows);
+        LVK_ASSERT(size.width > 0 && size.height > 0);
+        LVK_ASSERT(src.channels() == 3);
+        LVK_ASSERT(!src.empty());
+
+        if(size == src.size())
+        {
+            src.copyTo(dst);
+            return;
+        }
 
-        // Create next kernel while the last one runs.
-        kernel.create("easu_scale", yuv ? program_yuv : program_bgr);
-        kernel_is_yuv = yuv;
+        // NOTE: area interpolation averages every source pixel covered by the
+        // destination pixel, so it doesn't alias like bilinear downscaling does.
+        // OpenCV provides both an OpenCL kernel and a vectorized CPU path for it.
+        if(src.depth() == CV_16F)
+        {
+            // OpenCV can't resize half floats, so they are resized as full floats.
+            thread_local cv::UMat float_buffer;
+            src.convertTo(float_buffer, CV_32F);
+            cv::resize(float_buffer, float_buffer, size, 0, 0, cv::INTER_AREA);
+            float_buffer.convertTo(dst, CV_16F);
+        }
+        else cv::resize(src, dst, size, 0, 0, cv::INTER_AREA);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void downscale(const cv::UMat& src, std::vector<cv::UMat>& dst, const std::vector<cv::Size>& sizes)
+    {
+        LVK_ASSERT(!src.empty());
+
+        // Generate the largest sizes first, so that each smaller size can be made from
+        // the smallest existing output which still contains it. This way the source is
+        // only read in full once, like generating a mip-chain.
+        std::vector<size_t> order(sizes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b){
+            return sizes[a].area() > sizes[b].area();
+        });
+
+        dst.resize(sizes.size());
+        for(size_t i = 0; i < order.size(); i++)
+        {
+            const cv::Size& size = sizes[order[i]];
+
+            const cv::UMat* level = &src;
+            for(size_t j = 0; j < i; j++)
+            {
+                const cv::UMat& candidate = dst[order[j]];
+                if(candidate.cols >= size.width && candidate.rows >= size.height)
+                    level = &candidate;
+            }
+
+            downscale(*level, dst[order[i]], size);
+        }
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -128,31 +204,89 @@ namespace lvk
     void sharpen(const cv::UMat& src, cv::UMat& dst, const float sharpness)
     {
         LVK_ASSERT(src.cols > 0 && src.rows > 0);
-        LVK_ASSERT(src.type() == CV_8UC3);
+        LVK_ASSERT(src.channels() == 3);
         LVK_ASSERT_01(sharpness);
         LVK_ASSERT(!src.empty());
 
-        // Create FSR RCAS kernel
-        static auto program = ocl::load_program("fsr", ocl::src::fsr_source);
-        thread_local cv::ocl::Kernel kernel("rcas", program);
-        LVK_ASSERT(!program.empty() && !kernel.empty());
+        // NOTE: RCAS has no luma calculations, so the bgr program is used for all inputs.
+        const auto& program = fsr_program(src.depth(), false);
 
         // Allocate the output.
-        dst.create(src.size(), CV_8UC3);
+        dst.create(src.size(), src.type());
 
         // Find optimal work sizes for the 2D dst buffer.
         size_t global_work_size[3], local_work_size[3];
         ocl::optimal_groups(dst, global_work_size, local_work_size);
 
-        // Run the kernel in async mode.
-        kernel.args(
+        ocl::dispatch(
+            program,
+            "rcas",
+            2, global_work_size, local_work_size,
             cv::ocl::KernelArg::ReadOnly(src),
             cv::ocl::KernelArg::WriteOnlyNoSize(dst),
             std::exp2(-2.0f * (1.0f - sharpness))
-        ).run_(2, global_work_size, local_work_size, false);
+        );
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void upscale_sharpen(const cv::UMat& src, cv::UMat& dst, const cv::Size& size, const float sharpness, const bool yuv)
+    {
+        LVK_ASSERT(size.width >= src.cols && size.height >= src.rows);
+        LVK_ASSERT(src.cols > 0 && src.rows > 0);
+        LVK_ASSERT(src.channels() == 3);
+        LVK_ASSERT_01(sharpness);
+        LVK_ASSERT(!src.empty());
+
+        if(size == src.size())
+        {
+            sharpen(src, dst, sharpness);
+            return;
+        }
+
+        const auto& program = fsr_program(src.depth(), yuv);
+
+        // Allocate the output.
+        dst.create(size, src.type());
+
+        // NOTE: the kernel is compiled for 8x8 tiles, so its work groups are fixed.
+        // These are always used by the dispatch, which bypasses any work group tuning.
+        constexpr size_t tile_size = 8;
+        size_t local_work_size[3] = {tile_size, tile_size, 1};
+        size_t global_work_size[3] = {
+            ((static_cast<size_t>(dst.cols) + tile_size - 1) / tile_size) * tile_size,
+            ((static_cast<size_t>(dst.rows) + tile_size - 1) / tile_size) * tile_size,
+            1
+        };
+
+        ocl::dispatch(
+            program,
+            "easu_rcas_scale",
+            2, global_work_size, local_work_size,
+            cv::ocl::KernelArg::ReadOnly(src),
+            cv::ocl::KernelArg::WriteOnly(dst),
+            cv::Vec2f{
+                static_cast<float>(src.cols) / static_cast<float>(dst.cols),
+                static_cast<float>(src.rows) / static_cast<float>(dst.rows)
+            },
+            std::exp2(-2.0f * (1.0f - sharpness))
+        );
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
 
-        // Create next kernel while the last one runs.
-        kernel.create("rcas", program);
+    void extract_luma(const cv::UMat& src, cv::UMat& dst)
+    {
+        LVK_ASSERT(!src.empty());
+
+        cv::extractChannel(src, dst, 0);
+        switch(dst.depth())
+        {
+            case CV_8U:  break;
+            case CV_16U: dst.convertTo(dst, CV_8U, 1.0 / 257.0); break;
+            case CV_16F: dst.convertTo(dst, CV_8U, 255.0); break;
+            default: LVK_ASSERT(false && "Unsupported pixel depth");
+        }
     }
 
 //---------------------------------------------------------------------------------------------------------------------
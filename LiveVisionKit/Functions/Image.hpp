@@ -22,10 +22,28 @@
 namespace lvk
 {
 
+    // NOTE: these functions support 8-bit, 16-bit and half float frames.
+
     void remap(const cv::UMat& src, cv::UMat& dst, const cv::UMat& offset_map, const bool yuv = true);
 
     void upscale(const cv::UMat& src, cv::UMat& dst, const cv::Size& size, const bool yuv = true);
 
+    void downscale(const cv::UMat& src, cv::UMat& dst, const cv::Size& size);
+
+    void downscale(const cv::UMat& src, std::vector<cv::UMat>& dst, const std::vector<cv::Size>& sizes);
+
     void sharpen(const cv::UMat& src, cv::UMat& dst, const float sharpness = 0.7f);
 
+    // Equivalent to upscale followed by sharpen, without writing out the unsharpened frame.
+    void upscale_sharpen(
+        const cv::UMat& src,
+        cv::UMat& dst,
+        const cv::Size& size,
+        const float sharpness = 0.7f,
+        const bool yuv = true
+    );
+
+    // Extracts the luma of a YUV frame as 8-bit, shifting down higher bit depths.
+    void extract_luma(const cv::UMat& src, cv::UMat& dst);
+
 }
\ No newline at end of file
@@ -17,15 +17,201 @@
 
 #include "Kernels.hpp"
 
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+
 #include "Directives.hpp"
+#include "Timing/Time.hpp"
+#include "Functions/Text.hpp"
+
+#ifdef LVK_OPENCL_MARKERS
+    #define CL_TARGET_OPENCL_VERSION 120
+    #include <CL/cl.h>
+#endif
+
+namespace lvk::context
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::filesystem::path default_program_cache_directory()
+    {
+        // The cache location can be overridden through the environment, which is
+        // useful for sharing a single cache between many short-lived processes.
+        if(const char* env_directory = std::getenv("LVK_OPENCL_CACHE"); env_directory != nullptr)
+            return env_directory;
+
+        std::error_code error;
+        const auto temp_directory = std::filesystem::temp_directory_path(error);
+        return error ? std::filesystem::path() : temp_directory / "lvk-opencl-cache";
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::filesystem::path program_cache_directory = default_program_cache_directory();
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool tune_work_groups = false;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
 
 namespace lvk::ocl
 {
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::optional<std::filesystem::path> cached_program_path(
+        const char* name,
+        const char* source,
+        const char* flags
+    )
+    {
+        if(context::program_cache_directory.empty() || !cv::ocl::useOpenCL())
+            return std::nullopt;
+
+        const auto& device = cv::ocl::Device::getDefault();
+        if(!device.available())
+            return std::nullopt;
+
+        // Binaries are only valid for the exact device, driver, build flags and
+        // source they were compiled with. So the cache key is a hash of all of
+        // these properties, and any change will naturally miss the old binary.
+        const std::string key = device.vendorName() + '|' + device.name() + '|'
+                              + device.driverVersion() + '|' + device.version() + '|'
+                              + CV_VERSION + '|' + flags + '|' + source;
+
+        const auto key_hash = static_cast<unsigned long long>(fnv1a_hash(key));
+        return context::program_cache_directory / cv::format("%s-%016llx.bin", name, key_hash);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::optional<cv::ocl::Program> load_cached_program(
+        const std::filesystem::path& path,
+        const char* name,
+        const char* flags
+    )
+    {
+        // NOTE: OpenCV does not copy the binary when creating a program source,
+        // so we must keep all the loaded binaries alive for the program lifetime.
+        static std::mutex binary_mutex;
+        static std::deque<std::vector<uchar>> binary_storage;
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file.good())
+            return std::nullopt;
+
+        std::vector<uchar> binary(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if(binary.empty() || !file.read(reinterpret_cast<char*>(binary.data()), std::streamsize(binary.size())))
+            return std::nullopt;
+
+        std::scoped_lock lock(binary_mutex);
+        const auto& stored_binary = binary_storage.emplace_back(std::move(binary));
+
+        cv::String build_log;
+        const auto program_source = cv::ocl::ProgramSource::fromBinary(
+            name, name, stored_binary.data(), stored_binary.size(), flags
+        );
+        cv::ocl::Program program(program_source, flags, build_log);
+
+        if(program.ptr() == nullptr)
+        {
+            // The binary is corrupt or was rejected by the driver, so
+            // remove it from the cache to have it rebuilt from source.
+            binary_storage.pop_back();
+
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            return std::nullopt;
+        }
+        return std::move(program);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void store_cached_program(const cv::ocl::Program& program, const std::filesystem::path& path)
+    {
+        std::vector<char> binary;
+        program.getBinary(binary);
+        if(binary.empty())
+            return;
+
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        if(error) return;
+
+        // Write to a unique temporary file and move it into place afterwards so
+        // that concurrent processes never get to read a partially written binary.
+        auto temp_path = path;
+        temp_path += cv::format(".%llx.tmp", static_cast<unsigned long long>(Time::Now().nanoseconds()));
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if(!file.write(binary.data(), std::streamsize(binary.size())))
+            {
+                file.close();
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, path, error);
+        if(error) std::filesystem::remove(temp_path, error);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::mutex identity_mutex;
+    static std::map<void*, std::string> program_identities;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void register_program(const cv::ocl::Program& program, const char* name, const char* source, const char* flags)
+    {
+        // Program handles are only valid within this process, so we give each program
+        // a stable identity which can be used to persist information between processes.
+        const auto source_hash = static_cast<unsigned long long>(fnv1a_hash(std::string(flags) + '|' + source));
+
+        std::scoped_lock lock(identity_mutex);
+        program_identities[program.ptr()] = cv::format("%s-%016llx", name, source_hash);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::string program_identity(const cv::ocl::Program& program)
+    {
+        std::scoped_lock lock(identity_mutex);
+        const auto identity = program_identities.find(program.ptr());
+        return identity != program_identities.end() ? identity->second : std::string();
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
 cv::ocl::Program load_program(const char* name, const char* source, const char* flags)
 {
+    // Compiling programs from source is slow, so try to re-use a binary
+    // which was compiled previously under the exact same configuration.
+    const auto cache_path = cached_program_path(name, source, flags);
+    if(cache_path.has_value())
+    {
+        if(auto program = load_cached_program(*cache_path, name, flags); program.has_value())
+        {
+            register_program(*program, name, source, flags);
+            return std::move(*program);
+        }
+    }
+
     cv::String compilation_log;
 
     cv::ocl::ProgramSource program_source(name, name, source, "");
@@ -41,6 +227,11 @@ cv::ocl::Program load_program(const char* name, const char* source, const char*
         );
         return {};
     };
+
+    if(cache_path.has_value())
+        store_cached_program(program, *cache_path);
+
+    register_program(program, name, source, flags);
     return std::move(program);
 }
 
@@ -72,4 +263,366 @@ cv::ocl::Program load_program(const char* name, const char* source, const char*
 
 //---------------------------------------------------------------------------------------------------------------------
 
-}
\ No newline at end of file
+    static std::atomic<size_t> kernel_creation_count = 0;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static cv::ocl::Kernel& kernel_pool(const cv::ocl::Program& program, const char* name)
+    {
+        // Each thread holds a kernel which has never been launched per (program, kernel) pair.
+        // Note that the program handle is part of the key, so each program variant gets its own.
+        thread_local std::map<std::pair<void*, std::string>, cv::ocl::Kernel> registry;
+        return registry[{program.ptr(), name}];
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    cv::ocl::Kernel& ready_kernel(const cv::ocl::Program& program, const char* name)
+    {
+        LVK_ASSERT(!program.empty());
+
+        auto& kernel = kernel_pool(program, name);
+        if(kernel.empty())
+            renew_kernel(kernel, program, name);
+
+        return kernel;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void retire_kernel(cv::ocl::Kernel& kernel, const cv::ocl::Program& program, const char* name)
+    {
+        LVK_ASSERT(&kernel_pool(program, name) == &kernel);
+
+        // OpenCV flags asynchronously launched kernels so that they can never be launched
+        // again, and keeps them alive until they complete. So the launched kernel is swapped
+        // out for a new one while it runs, which is ready to be bound by the next dispatch.
+        renew_kernel(kernel, program, name);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void renew_kernel(cv::ocl::Kernel& kernel, const cv::ocl::Program& program, const char* name)
+    {
+        kernel.create(name, program);
+        kernel_creation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t kernel_creations()
+    {
+        return kernel_creation_count.load(std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    struct WorkGroupTuning
+    {
+        std::vector<cv::Size> candidates;
+        std::vector<int64_t> timings;
+        std::optional<cv::Size> optimal;
+        size_t trials = 0;
+    };
+
+    constexpr size_t WORK_GROUP_TUNING_ROUNDS = 3;
+
+    static std::mutex tuning_mutex;
+    static std::unordered_map<uint64_t, WorkGroupTuning> tuning_table;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::filesystem::path tuning_file_path()
+    {
+        if(context::program_cache_directory.empty())
+            return {};
+
+        return context::program_cache_directory / "work-groups.txt";
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void load_tuning_table()
+    {
+        // NOTE: the tuning mutex must be held by the caller.
+        static bool loaded = false;
+        if(loaded) return;
+        loaded = true;
+
+        const auto path = tuning_file_path();
+        if(path.empty()) return;
+
+        std::ifstream file(path);
+        std::string key_hex;
+        int width = 0, height = 0;
+        while(file >> key_hex >> width >> height)
+        {
+            if(width <= 0 || height <= 0)
+                continue;
+
+            const auto key = static_cast<uint64_t>(std::strtoull(key_hex.c_str(), nullptr, 16));
+            tuning_table[key].optimal = cv::Size(width, height);
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void store_tuning_result(const uint64_t key, const cv::Size& optimal)
+    {
+        const auto path = tuning_file_path();
+        if(path.empty()) return;
+
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        if(error) return;
+
+        // Each result is a single short line, so appending keeps
+        // the file consistent even when shared between processes.
+        std::ofstream file(path, std::ios::app);
+        file << cv::format("%016llx %d %d\n", static_cast<unsigned long long>(key), optimal.width, optimal.height);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static uint64_t tuning_key(
+        const cv::ocl::Program& program,
+        const char* name,
+        const int dimensions,
+        const size_t global_groups[3]
+    )
+    {
+        // The optimal work groups depend on the device, the kernel and the amount
+        // of work, so we key the tuning by all of them. The amount of work is given
+        // by the global work size, which is bucketed to powers of two so that kernels
+        // with varying work loads, such as point drawing, do not re-tune every call.
+        const auto bucket = [](size_t size) {
+            size_t bucket_size = 1;
+            while(bucket_size < size) bucket_size <<= 1;
+            return std::to_string(bucket_size);
+        };
+
+        const auto& device = cv::ocl::Device::getDefault();
+        const std::string key = device.vendorName() + '|' + device.name() + '|' + device.driverVersion() + '|'
+                              + program_identity(program) + '|' + name + '|' + std::to_string(dimensions) + '|'
+                              + bucket(global_groups[0]) + 'x' + bucket(global_groups[1]);
+
+        return fnv1a_hash(key);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::vector<cv::Size> work_group_candidates(cv::ocl::Kernel& kernel, const int dimensions)
+    {
+        const auto& device = cv::ocl::Device::getDefault();
+
+        size_t max_item_sizes[3] = {0, 0, 0};
+        device.maxWorkItemSizes(max_item_sizes);
+        const size_t max_group_size = std::min(kernel.workGroupSize(), device.maxWorkGroupSize());
+
+        // NOTE: 2D candidates are all multiples of 8 as the FSR kernels swizzle within 8x8 tiles.
+        static const std::vector<cv::Size> candidates_1d = {{32, 1}, {64, 1}, {128, 1}, {256, 1}};
+        static const std::vector<cv::Size> candidates_2d = {
+            {8, 8}, {16, 8}, {8, 16}, {16, 16}, {32, 8}, {8, 32}, {32, 16}, {64, 8}
+        };
+
+        std::vector<cv::Size> candidates;
+        for(const auto& candidate : dimensions == 1 ? candidates_1d : candidates_2d)
+        {
+            const auto width = static_cast<size_t>(candidate.width);
+            const auto height = static_cast<size_t>(candidate.height);
+
+            const bool fits_group = width * height <= max_group_size;
+            const bool fits_items = (max_item_sizes[0] == 0 || width <= max_item_sizes[0])
+                                 && (max_item_sizes[1] == 0 || height <= max_item_sizes[1]);
+
+            if(fits_group && fits_items)
+                candidates.push_back(candidate);
+        }
+        return candidates;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void apply_work_group(
+        const cv::Size& local_size,
+        const int dimensions,
+        size_t global_groups[3],
+        size_t local_groups[3]
+    )
+    {
+        local_groups[0] = static_cast<size_t>(local_size.width);
+        local_groups[1] = dimensions == 2 ? static_cast<size_t>(local_size.height) : 1;
+
+        // The global work size must be a multiple of the local work size.
+        for(int d = 0; d < dimensions; d++)
+            global_groups[d] = ((global_groups[d] + local_groups[d] - 1) / local_groups[d]) * local_groups[d];
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool launch_kernel(
+        cv::ocl::Kernel& kernel,
+        const cv::ocl::Program& program,
+        const char* name,
+        const int dimensions,
+        size_t global_groups[3],
+        size_t local_groups[3]
+    )
+    {
+        LVK_ASSERT(!kernel.empty());
+
+        // Kernels which declare a required work group size must always be launched with it.
+        size_t required_groups[3] = {0, 0, 0};
+        if(cv::ocl::useOpenCL() && kernel.compileWorkGroupSize(required_groups) && required_groups[0] != 0)
+        {
+            const cv::Size required_size(int(required_groups[0]), dimensions == 2 ? int(required_groups[1]) : 1);
+            apply_work_group(required_size, dimensions, global_groups, local_groups);
+
+            return kernel.run_(dimensions, global_groups, local_groups, false);
+        }
+
+        if(!context::tune_work_groups || !cv::ocl::useOpenCL())
+            return kernel.run_(dimensions, global_groups, local_groups, false);
+
+        const uint64_t key = tuning_key(program, name, dimensions, global_groups);
+
+        std::unique_lock lock(tuning_mutex);
+        load_tuning_table();
+
+        auto& tuning = tuning_table[key];
+        if(tuning.optimal.has_value())
+        {
+            const cv::Size optimal = *tuning.optimal;
+            lock.unlock();
+
+            apply_work_group(optimal, dimensions, global_groups, local_groups);
+            return kernel.run_(dimensions, global_groups, local_groups, false);
+        }
+
+        if(tuning.candidates.empty())
+        {
+            tuning.candidates = work_group_candidates(kernel, dimensions);
+            tuning.timings.assign(tuning.candidates.size(), std::numeric_limits<int64_t>::max());
+
+            // If no candidates are supported, stick with the given work groups.
+            if(tuning.candidates.empty())
+            {
+                tuning.optimal = cv::Size(int(local_groups[0]), dimensions == 2 ? int(local_groups[1]) : 1);
+                lock.unlock();
+
+                return kernel.run_(dimensions, global_groups, local_groups, false);
+            }
+        }
+
+        // Each dispatch benchmarks one candidate, so the tuning is spread over the first
+        // few frames. Profiled runs are synchronous, which stalls the pipeline until the
+        // tuning is complete, but the kernel still performs its work exactly once.
+        const size_t candidate_index = tuning.trials++ % tuning.candidates.size();
+        const cv::Size candidate = tuning.candidates[candidate_index];
+        lock.unlock();
+
+        const size_t default_global_groups[3] = {global_groups[0], global_groups[1], global_groups[2]};
+        const size_t default_local_groups[3] = {local_groups[0], local_groups[1], local_groups[2]};
+
+        apply_work_group(candidate, dimensions, global_groups, local_groups);
+        const int64_t time = kernel.runProfiling(dimensions, global_groups, local_groups);
+
+        lock.lock();
+        if(time >= 0)
+            tuning.timings[candidate_index] = std::min(tuning.timings[candidate_index], time);
+
+        if(!tuning.optimal.has_value() && tuning.trials >= tuning.candidates.size() * WORK_GROUP_TUNING_ROUNDS)
+        {
+            const auto fastest = std::min_element(tuning.timings.begin(), tuning.timings.end());
+            if(*fastest != std::numeric_limits<int64_t>::max())
+            {
+                tuning.optimal = tuning.candidates[std::distance(tuning.timings.begin(), fastest)];
+                store_tuning_result(key, *tuning.optimal);
+            }
+            else tuning.optimal = cv::Size(int(default_local_groups[0]), int(default_local_groups[1]));
+        }
+        lock.unlock();
+
+        if(time < 0)
+        {
+            // The candidate was rejected by the runtime, so run with the default work groups.
+            std::copy_n(default_global_groups, 3, global_groups);
+            std::copy_n(default_local_groups, 3, local_groups);
+            return kernel.run_(dimensions, global_groups, local_groups, false);
+        }
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#ifdef LVK_OPENCL_MARKERS
+
+    static void CL_CALLBACK on_marker_complete(cl_event, cl_int, void* user_data)
+    {
+        auto* timestamp = static_cast<std::shared_ptr<std::atomic<uint64_t>>*>(user_data);
+        (*timestamp)->store(static_cast<uint64_t>(Time::Now().nanoseconds()), std::memory_order_release);
+        (*timestamp)->notify_all();
+        delete timestamp;
+    }
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool supports_markers()
+    {
+#ifdef LVK_OPENCL_MARKERS
+        return cv::ocl::useOpenCL() && cv::ocl::Queue::getDefault().ptr() != nullptr;
+#else
+        return false;
+#endif
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<std::atomic<uint64_t>> queue_marker()
+    {
+#ifdef LVK_OPENCL_MARKERS
+        if(!supports_markers())
+            return nullptr;
+
+        auto queue = static_cast<cl_command_queue>(cv::ocl::Queue::getDefault().ptr());
+
+        cl_event marker = nullptr;
+        if(clEnqueueMarkerWithWaitList(queue, 0, nullptr, &marker) != CL_SUCCESS)
+            return nullptr;
+
+        // The marker completes once all work queued before it is done. Rather than
+        // waiting on it, we timestamp it from a completion callback on the driver's
+        // thread so that the host never has to stall the queue to time GPU work.
+        auto timestamp = std::make_shared<std::atomic<uint64_t>>(0);
+        auto* callback_data = new std::shared_ptr<std::atomic<uint64_t>>(timestamp);
+        if(clSetEventCallback(marker, CL_COMPLETE, on_marker_complete, callback_data) != CL_SUCCESS)
+        {
+            delete callback_data;
+            clReleaseEvent(marker);
+            return nullptr;
+        }
+
+        // Flush so the marker is guaranteed to complete without a later sync.
+        clFlush(queue);
+        clReleaseEvent(marker);
+
+        return timestamp;
+#else
+        return nullptr;
+#endif
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void wait_for_marker(const std::shared_ptr<std::atomic<uint64_t>>& marker)
+    {
+        // The marker's completion callback notifies its waiters, so we sleep rather than spin.
+        if(marker != nullptr)
+            marker->wait(0, std::memory_order_acquire);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
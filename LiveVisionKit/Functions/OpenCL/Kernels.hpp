@@ -18,9 +18,22 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <filesystem>
 #include <opencv2/opencv.hpp>
 #include <opencv2/core/ocl.hpp>
 
+namespace lvk::context
+{
+    // NOTE: an empty path disables the program binary cache.
+    extern std::filesystem::path program_cache_directory;
+
+    // NOTE: tuning is off by default as it profiles each candidate synchronously.
+    // Tuned work group sizes are persisted in the program cache directory.
+    extern bool tune_work_groups;
+}
+
 namespace lvk::ocl
 {
 
@@ -28,6 +41,43 @@ namespace lvk::ocl
 
     void optimal_groups(const cv::UMat& buffer, size_t global_groups[3], size_t local_groups[3]);
 
+    // NOTE: returns a kernel of the thread's pool which has never been launched.
+    cv::ocl::Kernel& ready_kernel(const cv::ocl::Program& program, const char* name);
+
+    // NOTE: must be called after launching a kernel given by ready_kernel, even on failure.
+    void retire_kernel(cv::ocl::Kernel& kernel, const cv::ocl::Program& program, const char* name);
+
+    void renew_kernel(cv::ocl::Kernel& kernel, const cv::ocl::Program& program, const char* name);
+
+    bool launch_kernel(
+        cv::ocl::Kernel& kernel,
+        const cv::ocl::Program& program,
+        const char* name,
+        const int dimensions,
+        size_t global_groups[3],
+        size_t local_groups[3]
+    );
+
+    template<typename... Args>
+    bool dispatch(
+        const cv::ocl::Program& program,
+        const char* kernel_name,
+        const int dimensions,
+        size_t global_groups[3],
+        size_t local_groups[3],
+        const Args&... args
+    );
+
+    size_t kernel_creations();
+
+    bool supports_markers();
+
+    // NOTE: the timestamp is zero until all previously queued work has completed.
+    std::shared_ptr<std::atomic<uint64_t>> queue_marker();
+
+    // NOTE: blocks until all work queued before the marker has completed.
+    void wait_for_marker(const std::shared_ptr<std::atomic<uint64_t>>& marker);
+
     // OpenCL Kernel Sources
     namespace src
     {
@@ -38,5 +88,11 @@ namespace lvk::ocl
         inline const char* drawing_source =
             #include "Sources/Drawing.cl"
 ;
+
+        inline const char* deblocking_source =
+            #include "Sources/Deblocking.cl"
+;
     }
 }
+
+#include "Kernels.tpp"
@@ -0,0 +1,55 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include "Directives.hpp"
+
+namespace lvk::ocl
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    template<typename... Args>
+    inline bool dispatch(
+        const cv::ocl::Program& program,
+        const char* kernel_name,
+        const int dimensions,
+        size_t global_groups[3],
+        size_t local_groups[3],
+        const Args&... args
+    )
+    {
+        LVK_ASSERT(!program.empty());
+        LVK_ASSERT(dimensions == 1 || dimensions == 2);
+
+        auto& kernel = ready_kernel(program, kernel_name);
+        LVK_ASSERT(!kernel.empty());
+
+        kernel.args(args...);
+        const bool success = launch_kernel(kernel, program, kernel_name, dimensions, global_groups, local_groups);
+
+        // NOTE: the launched kernel is replaced, as OpenCV can't launch it again.
+        retire_kernel(kernel, program, kernel_name);
+
+        LVK_ASSERT(success && "Failed to launch the OpenCL kernel");
+        return success;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
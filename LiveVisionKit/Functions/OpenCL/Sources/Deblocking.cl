@@ -0,0 +1,151 @@
+R"(
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+// NOTE: these kernels mirror the CPU implementation of the deblocking filter.
+
+// Frames are 8-bit unless the program is built with DEPTH_16U or DEPTH_16F. Half float
+// frames use a full float smooth frame, as OpenCV can't resize or median filter them.
+// Detection always happens on luma scaled to 8-bit units, so the thresholds stay the same.
+#if defined(DEPTH_16U)
+    #define PIXEL_SIZE 2
+    #define SMOOTH_PIXEL_SIZE 2
+    #define LUMA_SCALE 0.00389105058f
+
+    float load_luma(__global const uchar* p){return (float)(*(__global const ushort*)p);}
+    float3 load_px3(__global const uchar* p){return convert_float3(vload3(0, (__global const ushort*)p));}
+    float3 load_smooth3(__global const uchar* p){return load_px3(p);}
+    void store_px3(float3 v, __global uchar* p){vstore3(convert_ushort3_sat_rte(v), 0, (__global ushort*)p);}
+#elif defined(DEPTH_16F)
+    #define PIXEL_SIZE 2
+    #define SMOOTH_PIXEL_SIZE 4
+    #define LUMA_SCALE 255.0f
+
+    float load_luma(__global const uchar* p){return vload_half(0, (__global const half*)p);}
+    float3 load_px3(__global const uchar* p){return vload_half3(0, (__global const half*)p);}
+    float3 load_smooth3(__global const uchar* p){return vload3(0, (__global const float*)p);}
+    void store_px3(float3 v, __global uchar* p){vstore_half3(v, 0, (__global half*)p);}
+#else
+    #define PIXEL_SIZE 1
+    #define SMOOTH_PIXEL_SIZE 1
+    #define LUMA_SCALE 1.0f
+
+    float load_luma(__global const uchar* p){return (float)(*p);}
+    float3 load_px3(__global const uchar* p){return convert_float3(vload3(0, p));}
+    float3 load_smooth3(__global const uchar* p){return load_px3(p);}
+    void store_px3(float3 v, __global uchar* p){vstore3(convert_uchar3_sat_rte(v), 0, p);}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Matches the source coordinates used by OpenCV's bilinear resize.
+void linear_sample_coords(const int coord, const float scale, const int size, int* c0, int* c1, float* t)
+{
+    const float source = fmax((coord + 0.5f) * scale - 0.5f, 0.0f);
+    const int base = (int)floor(source);
+
+    *t = (base >= size - 1) ? 0.0f : source - base;
+    *c0 = min(base, size - 1);
+    *c1 = min(base + 1, size - 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+__kernel void block_weights(
+    __global const uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
+    __global uchar* weights, int weights_step, int weights_offset, int weights_rows, int weights_cols,
+    int block_size, int detection_levels
+)
+{
+    const int2 block = (int2)(get_global_id(0), get_global_id(1));
+    if(block.x >= weights_cols || block.y >= weights_rows)
+        return;
+
+    const int origin = src_offset + block.y * block_size * src_step + PIXEL_SIZE * 3 * block.x * block_size;
+    const float area = (float)(block_size * block_size);
+
+    // Find the average luma of the block, this is the maximal blocking artifact reference.
+    float luma_sum = 0.0f;
+    for(int y = 0; y < block_size; y++)
+    {
+        __global const uchar* row = src + origin + y * src_step;
+        for(int x = 0; x < block_size; x++)
+            luma_sum += load_luma(row + PIXEL_SIZE * 3 * x) * LUMA_SCALE;
+    }
+    const float reference = rint(luma_sum / area);
+
+    // Blocks which deviate little from the reference are likely to be blocking
+    // artifacts. The more detail there is, the more of the original is kept.
+    float deviation_sum = 0.0f;
+    for(int y = 0; y < block_size; y++)
+    {
+        __global const uchar* row = src + origin + y * src_step;
+        for(int x = 0; x < block_size; x++)
+            deviation_sum += fabs(load_luma(row + PIXEL_SIZE * 3 * x) * LUMA_SCALE - reference);
+    }
+    const float deviation = rint(deviation_sum / area);
+
+    __global float* weight = (__global float*)(weights + weights_offset + block.y * weights_step) + block.x;
+    *weight = fmin(deviation, (float)detection_levels) / (float)detection_levels;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+__kernel void deblock_blend(
+    __global uchar* frame, int frame_step, int frame_offset, int frame_rows, int frame_cols,
+    __global const uchar* smooth, int smooth_step, int smooth_offset, int smooth_rows, int smooth_cols,
+    __global const uchar* weights, int weights_step, int weights_offset, int weights_rows, int weights_cols
+)
+{
+    const int2 coord = (int2)(get_global_id(0), get_global_id(1));
+    if(coord.x >= frame_cols || coord.y >= frame_rows)
+        return;
+
+    // Bilinearly sample the keep weight from the block weights.
+    int wx0, wx1, wy0, wy1; float wtx, wty;
+    linear_sample_coords(coord.x, (float)weights_cols / frame_cols, weights_cols, &wx0, &wx1, &wtx);
+    linear_sample_coords(coord.y, (float)weights_rows / frame_rows, weights_rows, &wy0, &wy1, &wty);
+
+    __global const float* weight_row0 = (__global const float*)(weights + weights_offset + wy0 * weights_step);
+    __global const float* weight_row1 = (__global const float*)(weights + weights_offset + wy1 * weights_step);
+    const float keep = mix(
+        mix(weight_row0[wx0], weight_row0[wx1], wtx),
+        mix(weight_row1[wx0], weight_row1[wx1], wtx),
+        wty
+    );
+
+    // Bilinearly sample the upscaled smooth frame.
+    int sx0, sx1, sy0, sy1; float stx, sty;
+    linear_sample_coords(coord.x, (float)smooth_cols / frame_cols, smooth_cols, &sx0, &sx1, &stx);
+    linear_sample_coords(coord.y, (float)smooth_rows / frame_rows, smooth_rows, &sy0, &sy1, &sty);
+
+    __global const uchar* smooth_row0 = smooth + smooth_offset + sy0 * smooth_step;
+    __global const uchar* smooth_row1 = smooth + smooth_offset + sy1 * smooth_step;
+    const float3 smooth_pixel = mix(
+        mix(load_smooth3(smooth_row0 + SMOOTH_PIXEL_SIZE * 3 * sx0), load_smooth3(smooth_row0 + SMOOTH_PIXEL_SIZE * 3 * sx1), stx),
+        mix(load_smooth3(smooth_row1 + SMOOTH_PIXEL_SIZE * 3 * sx0), load_smooth3(smooth_row1 + SMOOTH_PIXEL_SIZE * 3 * sx1), stx),
+        sty
+    );
+
+    // Adaptively blend the original and smooth pixels.
+    __global uchar* pixel = frame + frame_offset + coord.y * frame_step + PIXEL_SIZE * 3 * coord.x;
+    store_px3(mix(smooth_pixel, load_px3(pixel), keep), pixel);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// )"
@@ -76,6 +76,43 @@ float4 APrxMedRcpF4(float4 a){float4 b = as_float4((uint4)(0x7ef19fff) - as_uint
 //                                                    HELPER FUNCTIONS
 //======================================================================================================================
 
+// Frames are 8-bit unless the program is built with DEPTH_16U or DEPTH_16F. Pixels are
+// loaded as floats in their native units, that is 0-255, 0-65535, or 0-1 for half floats.
+#if defined(DEPTH_16U)
+    #define PIXEL_SIZE 2
+    #define PIXEL_MAX 65535.0f
+    #define NORM_FACTOR 0.0000152590219f
+
+    float3 load_px3(__global const uchar* p){return convert_float3(vload3(0, (__global const ushort*)p));}
+    float8 load_px8(__global const uchar* p){return convert_float8(vload8(0, (__global const ushort*)p));}
+    float16 load_px16(__global const uchar* p){return convert_float16(vload16(0, (__global const ushort*)p));}
+    float3 quantize_px3(float3 v){return floor(clamp(v, 0.0f, PIXEL_MAX));}
+    void store_px3(float3 v, __global uchar* p){vstore3(convert_ushort3_sat(v), 0, (__global ushort*)p);}
+    void copy_px3(__global const uchar* src, __global uchar* dst){vstore3(vload3(0, (__global const ushort*)src), 0, (__global ushort*)dst);}
+#elif defined(DEPTH_16F)
+    #define PIXEL_SIZE 2
+    #define PIXEL_MAX 1.0f
+    #define NORM_FACTOR 1.0f
+
+    float3 load_px3(__global const uchar* p){return vload_half3(0, (__global const half*)p);}
+    float8 load_px8(__global const uchar* p){return vload_half8(0, (__global const half*)p);}
+    float16 load_px16(__global const uchar* p){return vload_half16(0, (__global const half*)p);}
+    float3 quantize_px3(float3 v){return v;}
+    void store_px3(float3 v, __global uchar* p){vstore_half3(v, 0, (__global half*)p);}
+    void copy_px3(__global const uchar* src, __global uchar* dst){vstore3(vload3(0, (__global const ushort*)src), 0, (__global ushort*)dst);}
+#else
+    #define PIXEL_SIZE 1
+    #define PIXEL_MAX 255.0f
+    #define NORM_FACTOR 0.00392156862f
+
+    float3 load_px3(__global const uchar* p){return convert_float3(vload3(0, p));}
+    float8 load_px8(__global const uchar* p){return convert_float8(vload8(0, p));}
+    float16 load_px16(__global const uchar* p){return convert_float16(vload16(0, p));}
+    float3 quantize_px3(float3 v){return floor(clamp(v, 0.0f, PIXEL_MAX));}
+    void store_px3(float3 v, __global uchar* p){vstore3(convert_uchar3_sat(v), 0, p);}
+    void copy_px3(__global const uchar* src, __global uchar* dst){vstore3(vload3(0, src), 0, dst);}
+#endif
+
 float saturate(float x){return fmax(0.0f, fmin(1.0f, x));}
 
 float3 max4(float3 a, float3 b, float3 c, float3 d){return max(a, max(b, max(c, d)));}
@@ -90,6 +127,13 @@ uint ABfiM(uint src, uint ins, uint bits){uint mask = (1u << bits) - 1; return (
 int2 remap8x8(uint id){return convert_int2((uint2)(ABfe(id, 1u, 3u), ABfiM(ABfe(id, 3u, 3u), id, 1u)));}
 int2 remapRed8x8(uint id){return convert_int2((uint2)(ABfiM(ABfe(id,2u,3u),id,1u),ABfiM(ABfe(id,3u,3u),ABfe(id,1u,2u),2u)));}
 
+// Swizzles the work item within its 8x8 tile, work group dimensions must be multiples of 8.
+int2 swizzled_coord()
+{
+    uint id = (get_local_id(1) & 7u) * 8u + (get_local_id(0) & 7u);
+    return remapRed8x8(id) + (int2)((int)get_global_id(0) & ~7, (int)get_global_id(1) & ~7);
+}
+
 //======================================================================================================================
 //                                    FSR - [EASU] EDGE ADAPTIVE SPATIAL UPSAMPLING
 //======================================================================================================================
@@ -178,7 +222,7 @@ void easu_accumulate(
 // )" R"(
 //----------------------------------------------------------------------------------------------------------------------
 
-void easu(__global uchar* src, int src_step, int src_offset, int2 src_coord, float2 sub_pixel, uchar3* dst_pixel)
+float3 easu(__global uchar* src, int src_step, int src_offset, int2 src_coord, float2 sub_pixel)
 {
 
     // Required pixel load ops, given that we are processing the current point 'f'.
@@ -193,21 +237,14 @@ void easu(__global uchar* src, int src_step, int src_offset, int2 src_coord, flo
     //      +---+---+   
     //
 
-    int r0_index = (src_coord.y - 1) * src_step + (3 * src_coord.x) + src_offset;
-    int r1_index = r0_index + src_step - 3;
-
-    uchar8 r0_data  =  vload8(0, src + r0_index); 
-    uchar16 r1_data = vload16(0, src + r1_index); 
-    uchar16 r2_data = vload16(0, src + r1_index + src_step); 
-    uchar8 r3_data  =  vload8(0, src + r0_index + 3 * src_step); 
+    int r0_index = (src_coord.y - 1) * src_step + PIXEL_SIZE * (3 * src_coord.x) + src_offset;
+    int r1_index = r0_index + src_step - PIXEL_SIZE * 3;
 
-    // Convert from uchars to float representation
-    const float norm_factor = 0.00392156862f;
-
-    float8 r0_px  =  convert_float8(r0_data) * norm_factor;
-    float16 r1_px = convert_float16(r1_data) * norm_factor;
-    float16 r2_px = convert_float16(r2_data) * norm_factor;
-    float8 r3_px  =  convert_float8(r3_data) * norm_factor;
+    // Load and normalize the pixels to float representation
+    float8 r0_px  =  load_px8(src + r0_index) * NORM_FACTOR;
+    float16 r1_px = load_px16(src + r1_index) * NORM_FACTOR;
+    float16 r2_px = load_px16(src + r1_index + src_step) * NORM_FACTOR;
+    float8 r3_px  =  load_px8(src + r0_index + 3 * src_step) * NORM_FACTOR;
 
     // NOTE: BGR format is used instead of RGB
     float4 bczzR = (float4)(r0_px.s0, r0_px.s3, 0, 0);
@@ -314,47 +351,54 @@ void easu(__global uchar* src, int src_step, int src_offset, int2 src_coord, flo
 
     // Normalize and dering.
     float3 fpx = min(ma4, max(mi4, aC * (float3)(native_recip(aW))));
-    *dst_pixel = convert_uchar3(fpx * 255.0f);
+    return fpx * PIXEL_MAX;
 }
 
 // )" R"(
 //----------------------------------------------------------------------------------------------------------------------
 
 
-__kernel void easu_scale(
+float3 easu_scale_pixel(
     __global uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
-    __global uchar* dst, int dst_step, int dst_offset, int dst_rows, int dst_cols,
+    int2 dst_coord,
     float2 rscale // Inverse scaling (from the point of view of the dst)
 )
 {
-    // Swizzle the threads for potentially better cache use.
-    int id = get_local_id(1) * 8 + get_local_id(0);
-    
-    int2 dst_coord = remapRed8x8(id) + (int2)(get_group_id(0) << 3, get_group_id(1) << 3); 
     float2 sub_pixel = convert_float2(dst_coord) * rscale;
     int2 src_coord = convert_int2_rtz(sub_pixel);
     sub_pixel -= floor(sub_pixel);
 
-    // Nest the border conditions together to help load balance and minimize branches.
-    if(src_coord.x == 0 || src_coord.y == 0 || src_coord.x >= src_cols - 4 || src_coord.y >= src_rows - 4 || dst_coord.x >= dst_cols || dst_coord.y >= dst_rows)
+    // If we are out of the src bounds, scale by nearest neighbour.
+    if(src_coord.x == 0 || src_coord.y == 0 || src_coord.x >= src_cols - 4 || src_coord.y >= src_rows - 4)
     {
-        // If we are out of the src bounds (but inside dst bounds), scale by nearest neighbour. 
-        if(dst_coord.x < dst_cols && dst_coord.y < dst_rows)
-        {
-            int src_index = src_coord.y * src_step + (3 * src_coord.x) + src_offset;
-            int dst_index = dst_coord.y * dst_step + (3 * dst_coord.x) + dst_offset;
-            vstore3(vload3(0, src + src_index), 0, dst + dst_index);
-        }
-        return;
+        int src_index = src_coord.y * src_step + PIXEL_SIZE * (3 * src_coord.x) + src_offset;
+        return load_px3(src + src_index);
     }
 
     // Run EASU
-    uchar3 dst_pixel;
-    easu(src, src_step, src_offset, src_coord, sub_pixel, &dst_pixel);
+    return easu(src, src_step, src_offset, src_coord, sub_pixel);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+__kernel void easu_scale(
+    __global uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
+    __global uchar* dst, int dst_step, int dst_offset, int dst_rows, int dst_cols,
+    float2 rscale // Inverse scaling (from the point of view of the dst)
+)
+{
+    // Swizzle the threads for potentially better cache use.
+    int2 dst_coord = swizzled_coord();
+
+    // Exit early if out of bounds (for uneven output sizes)
+    if(dst_coord.x >= dst_cols || dst_coord.y >= dst_rows)
+        return;
+
+    float3 dst_pixel = easu_scale_pixel(src, src_step, src_offset, src_rows, src_cols, dst_coord, rscale);
 
     // Write pixel.
-    int dst_index = dst_coord.y * dst_step + (3 * dst_coord.x) + dst_offset;
-    vstore3(dst_pixel, 0, dst + dst_index);
+    int dst_index = dst_coord.y * dst_step + PIXEL_SIZE * (3 * dst_coord.x) + dst_offset;
+    store_px3(dst_pixel, dst + dst_index);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -366,8 +410,7 @@ __kernel void easu_remap(
 )
 {
     // Swizzle the threads for potentially better cache use.
-    int id = get_local_id(1) * 8 + get_local_id(0);
-    int2 dst_coord = remapRed8x8(id) + (int2)(get_group_id(0) << 3, get_group_id(1) << 3); 
+    int2 dst_coord = swizzled_coord();
 
     // Exit early if out of bounds (for uneven output sizes)
     if(dst_coord.x >= dst_bounds.z || dst_coord.y >= dst_bounds.w)
@@ -383,23 +426,23 @@ __kernel void easu_remap(
     sub_pixel -= floor(sub_pixel);
 
     // Nest the border conditions on the src to help load balance and minimize branches.
-    uchar3 dst_pixel = (uchar3)(0, 0, 0);
+    float3 dst_pixel = (float3)(0.0f);
     if(src_coord.x < 1 || src_coord.y < 1 || src_coord.x >= src_cols - 4 || src_coord.y >= src_rows - 4)
     {
         // If we are still within the overall src bounds use nearest neighbour. 
         if(src_coord.x >= 0 && src_coord.x < src_cols && src_coord.y >= 0 && src_coord.y < src_rows)
         {
-            int src_index = src_coord.y * src_step + (3 * src_coord.x) + src_offset;
-            int dst_index = dst_coord.y * dst_step + (3 * dst_coord.x) + dst_offset;
-            vstore3(vload3(0, src + src_index), 0, dst + dst_index);
+            int src_index = src_coord.y * src_step + PIXEL_SIZE * (3 * src_coord.x) + src_offset;
+            int dst_index = dst_coord.y * dst_step + PIXEL_SIZE * (3 * dst_coord.x) + dst_offset;
+            copy_px3(src + src_index, dst + dst_index);
             return;
         }
     }
-    else easu(src, src_step, src_offset, src_coord, sub_pixel, &dst_pixel);
+    else dst_pixel = easu(src, src_step, src_offset, src_coord, sub_pixel);
 
     // Write pixel.
-    int dst_index = dst_coord.y * dst_step + (3 * dst_coord.x) + dst_offset;
-    vstore3(dst_pixel, 0, dst + dst_index);
+    int dst_index = dst_coord.y * dst_step + PIXEL_SIZE * (3 * dst_coord.x) + dst_offset;
+    store_px3(dst_pixel, dst + dst_index);
 }
 
 // )" R"(
@@ -407,45 +450,13 @@ __kernel void easu_remap(
 //                                      FSR - [RCAS] ROBUST CONTRAST ADAPTIVE SHARPENING
 //==============================================================================================================================
 
-__kernel void rcas(
-    __global uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
-    __global uchar* dst, int dst_step, int dst_offset, float sharpness
-)
-{ 
+float3 rcas_filter(float3 b, float3 d, float3 e, float3 f, float3 h, float sharpness)
+{
     // Algorithm uses minimal 3x3 pixel neighborhood.
     //    b 
     //  d e f
     //    h
 
-    // Swizzle the threads for potentially better cache use.
-    int id = get_local_id(1) * 8 + get_local_id(0);
-    int2 coord = remapRed8x8(id) + (int2)(get_group_id(0) << 3, get_group_id(1) << 3); 
-
-    int src_index = coord.y * src_step + (3 * coord.x) + src_offset;
-    int dst_index = coord.y * dst_step + (3 * coord.x) + dst_offset;
-
-    // Nest the border conditions together to help load balance and minimize branches.
-    if(coord.x == 0 || coord.x >= src_cols - 1 || coord.y == 0 || coord.y >= src_rows - 1)
-    {
-        // Perform direct copy if we are on the border of the image. 
-        if(coord.x <= src_cols || coord.y <= src_rows)
-            vstore3(vload3(0, src + src_index), 0, dst + dst_index);
-        return;
-    }
-
-    // Do not run sharpening on edges to avoid going out of bounds
-    const float norm_factor = 0.00392156862f;
-
-    uchar3 r0 = vload3(0, src + src_index - src_step);
-    uchar8 r1 = vload8(0, src + src_index - 3);
-    uchar3 r2 = vload3(0, src + src_index + src_step);
-
-    float3 b = convert_float3(r0) * norm_factor;
-    float3 h = convert_float3(r2) * norm_factor;
-    float3 d = convert_float3((uchar3)(r1.s0, r1.s1, r1.s2)) * norm_factor;
-    float3 e = convert_float3((uchar3)(r1.s3, r1.s4, r1.s5)) * norm_factor;
-    float3 f = convert_float3((uchar3)(r1.s6, r1.s7, src[src_index + 5])) * norm_factor;
-    
     // Rename 
     float bR=b.r; float bG=b.g; float bB=b.b;
     float dR=d.r; float dG=d.g; float dB=d.b;
@@ -478,10 +489,106 @@ __kernel void rcas(
 
     // Resolve, which needs the medium precision rcp approximation to avoid visible tonality changes.
     float rcpL = APrxMedRcpF1(4.0f * lobe + 1.0f);
-    float3 fpx = (((b + d + h + f) * lobe) + e) * rcpL;
+    return (((b + d + h + f) * lobe) + e) * rcpL;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+__kernel void rcas(
+    __global uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
+    __global uchar* dst, int dst_step, int dst_offset, float sharpness
+)
+{ 
+    // Algorithm uses minimal 3x3 pixel neighborhood.
+    //    b 
+    //  d e f
+    //    h
+
+    // Swizzle the threads for potentially better cache use.
+    int2 coord = swizzled_coord();
+
+    int src_index = coord.y * src_step + PIXEL_SIZE * (3 * coord.x) + src_offset;
+    int dst_index = coord.y * dst_step + PIXEL_SIZE * (3 * coord.x) + dst_offset;
+
+    // Nest the border conditions together to help load balance and minimize branches.
+    if(coord.x == 0 || coord.x >= src_cols - 1 || coord.y == 0 || coord.y >= src_rows - 1)
+    {
+        // Perform direct copy if we are on the border of the image. 
+        if(coord.x < src_cols && coord.y < src_rows)
+            copy_px3(src + src_index, dst + dst_index);
+        return;
+    }
 
-    uchar3 dst_pixel = convert_uchar3(fpx * 255.0f);
-    vstore3(dst_pixel, 0, dst + dst_index);
+    // Do not run sharpening on edges to avoid going out of bounds
+    float3 b = load_px3(src + src_index - src_step) * NORM_FACTOR;
+    float3 h = load_px3(src + src_index + src_step) * NORM_FACTOR;
+    float3 d = load_px3(src + src_index - PIXEL_SIZE * 3) * NORM_FACTOR;
+    float3 e = load_px3(src + src_index) * NORM_FACTOR;
+    float3 f = load_px3(src + src_index + PIXEL_SIZE * 3) * NORM_FACTOR;
+
+    float3 fpx = rcas_filter(b, d, e, f, h, sharpness);
+    store_px3(fpx * PIXEL_MAX, dst + dst_index);
 } 
 
+// )" R"(
+//==============================================================================================================================
+//                                      FSR - [EASU + RCAS] FUSED UPSCALING AND SHARPENING
+//==============================================================================================================================
+
+#define FUSED_TILE_SIZE 8
+#define FUSED_HALO_TILE_SIZE (FUSED_TILE_SIZE + 2)
+
+__kernel __attribute__((reqd_work_group_size(FUSED_TILE_SIZE, FUSED_TILE_SIZE, 1))) void easu_rcas_scale(
+    __global uchar* src, int src_step, int src_offset, int src_rows, int src_cols,
+    __global uchar* dst, int dst_step, int dst_offset, int dst_rows, int dst_cols,
+    float2 rscale, // Inverse scaling (from the point of view of the dst)
+    float sharpness
+)
+{
+    // The work group upscales its tile of the dst, plus a one pixel halo for RCAS,
+    // into local memory. The upscaled frame is then never written out in full.
+    __local float3 tile[FUSED_HALO_TILE_SIZE * FUSED_HALO_TILE_SIZE];
+
+    const int2 local_coord = (int2)(get_local_id(0), get_local_id(1));
+    const int2 tile_origin = (int2)(get_group_id(0), get_group_id(1)) * FUSED_TILE_SIZE - 1;
+    const int2 dst_limit = (int2)(dst_cols - 1, dst_rows - 1);
+
+    // NOTE: the halo has more pixels than there are work items, so some run EASU twice.
+    // Halo pixels outside the dst are clamped, they are only used by the border pixels
+    // which are never sharpened.
+    int index = local_coord.y * FUSED_TILE_SIZE + local_coord.x;
+    for(; index < FUSED_HALO_TILE_SIZE * FUSED_HALO_TILE_SIZE; index += FUSED_TILE_SIZE * FUSED_TILE_SIZE)
+    {
+        int2 tile_coord = (int2)(index % FUSED_HALO_TILE_SIZE, index / FUSED_HALO_TILE_SIZE);
+        int2 dst_coord = clamp(tile_origin + tile_coord, (int2)(0), dst_limit);
+        tile[index] = quantize_px3(easu_scale_pixel(src, src_step, src_offset, src_rows, src_cols, dst_coord, rscale));
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    int2 coord = tile_origin + local_coord + 1;
+    if(coord.x >= dst_cols || coord.y >= dst_rows)
+        return;
+
+    int center = (local_coord.y + 1) * FUSED_HALO_TILE_SIZE + local_coord.x + 1;
+    float3 dst_pixel = tile[center];
+
+    // Do not run sharpening on edges, matching the standalone RCAS pass.
+    if(coord.x > 0 && coord.x < dst_cols - 1 && coord.y > 0 && coord.y < dst_rows - 1)
+    {
+        float3 b = tile[center - FUSED_HALO_TILE_SIZE] * NORM_FACTOR;
+        float3 d = tile[center - 1] * NORM_FACTOR;
+        float3 e = dst_pixel * NORM_FACTOR;
+        float3 f = tile[center + 1] * NORM_FACTOR;
+        float3 h = tile[center + FUSED_HALO_TILE_SIZE] * NORM_FACTOR;
+
+        float3 fpx = rcas_filter(b, d, e, f, h, sharpness);
+        dst_pixel = fpx * PIXEL_MAX;
+    }
+
+    // Write pixel.
+    int dst_index = coord.y * dst_step + PIXEL_SIZE * (3 * coord.x) + dst_offset;
+    store_px3(dst_pixel, dst + dst_index);
+}
+
+
 // )"
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <algorithm>
 #include <functional>
 
@@ -33,6 +34,9 @@ namespace lvk
         }
     );
 
+    // 64-bit FNV-1a hash, the hash can be chained across strings by passing in the previous result.
+    uint64_t fnv1a_hash(const std::string& data, uint64_t hash = 14695981039346656037ull);
+
 }
 
 #include "Text.tpp"
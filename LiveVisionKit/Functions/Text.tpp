@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <sstream>
 #include <algorithm>
 #include <functional>
@@ -61,6 +62,18 @@ namespace lvk
         return output;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    inline uint64_t fnv1a_hash(const std::string& data, uint64_t hash)
+    {
+        for(const auto byte : data)
+        {
+            hash ^= static_cast<uint8_t>(byte);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
 }
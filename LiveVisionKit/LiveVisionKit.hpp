@@ -35,11 +35,16 @@
 #include "Filters/CompositeFilter.hpp"
 #include "Filters/ConversionFilter.hpp"
 #include "Filters/DeblockingFilter.hpp"
+#include "Filters/DenoisingFilter.hpp"
+#include "Filters/FrameRateFilter.hpp"
+#include "Filters/LensCorrectionFilter.hpp"
+#include "Filters/ParallelFilter.hpp"
 #include "Filters/StabilizationFilter.hpp"
 
 
 #include "Logging/Logger.hpp"
 #include "Logging/CSVLogger.hpp"
+#include "Logging/AsyncCSVLogger.hpp"
 
 
 #include "Math/WarpField.hpp"
@@ -50,9 +55,12 @@
 
 #include "Structures/SpatialMap.hpp"
 #include "Structures/StreamBuffer.hpp"
+#include "Structures/FrameSpool.hpp"
 
 #include "Timing/Time.hpp"
 #include "Timing/Stopwatch.hpp"
+#include "Timing/LatencyHistogram.hpp"
+#include "Timing/Tracing.hpp"
 #include "Timing/TickTimer.hpp"
 
 
@@ -0,0 +1,228 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "AsyncCSVLogger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <iomanip>
+
+#include "Directives.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    constexpr auto WRITER_IDLE_PERIOD = std::chrono::milliseconds(2);
+    constexpr char BINARY_MAGIC[4] = {'L', 'V', 'K', 'C'};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    AsyncCSVLogger::AsyncCSVLogger(
+        const std::filesystem::path& path,
+        std::vector<std::string> columns,
+        const Format format,
+        const size_t capacity
+    )
+        : m_Stream(path, format == Format::CSV ? std::ios::out : std::ios::out | std::ios::binary),
+          m_Format(format),
+          m_Columns(std::move(columns)),
+          m_Capacity(capacity)
+    {
+        LVK_ASSERT(!m_Columns.empty());
+        LVK_ASSERT(capacity > 1);
+
+        // All record memory is allocated up front, so logging never allocates.
+        m_Records.resize(m_Capacity * m_Columns.size(), 0.0);
+        m_ColumnBuffer.resize(m_Capacity, 0.0);
+
+        write_header();
+        m_Failed = !m_Stream.good();
+
+        m_WriterThread = std::thread(&AsyncCSVLogger::run_writer, this);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    AsyncCSVLogger::~AsyncCSVLogger()
+    {
+        m_Running.store(false, std::memory_order_release);
+        if(m_WriterThread.joinable())
+            m_WriterThread.join();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool AsyncCSVLogger::push(std::span<const double> values)
+    {
+        LVK_ASSERT(values.size() <= m_Columns.size());
+
+        // NOTE: one slot is kept empty to tell apart a full and empty ring.
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        const size_t next_head = (head + 1) % m_Capacity;
+        if(next_head == m_Tail.load(std::memory_order_acquire))
+        {
+            // The writer has fallen behind, drop the record rather than block.
+            m_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Missing trailing values are padded with NaN, which is written as an empty field.
+        const auto record = m_Records.begin() + static_cast<std::ptrdiff_t>(head * m_Columns.size());
+        std::copy(values.begin(), values.end(), record);
+        std::fill(
+            record + static_cast<std::ptrdiff_t>(values.size()),
+            record + static_cast<std::ptrdiff_t>(m_Columns.size()),
+            std::numeric_limits<double>::quiet_NaN()
+        );
+
+        m_Head.store(next_head, std::memory_order_release);
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void AsyncCSVLogger::flush()
+    {
+        // Wait for the writer to drain all the records pushed so far.
+        const size_t head = m_Head.load(std::memory_order_acquire);
+        while(m_Tail.load(std::memory_order_acquire) != head && m_WriterThread.joinable())
+            std::this_thread::sleep_for(WRITER_IDLE_PERIOD);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const std::vector<std::string>& AsyncCSVLogger::columns() const
+    {
+        return m_Columns;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t AsyncCSVLogger::dropped_records() const
+    {
+        return m_Dropped.load(std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool AsyncCSVLogger::has_error() const
+    {
+        return m_Failed.load(std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void AsyncCSVLogger::write_header()
+    {
+        if(m_Format == Format::CSV)
+        {
+            for(size_t i = 0; i < m_Columns.size(); i++)
+                m_Stream << (i > 0 ? "," : "") << m_Columns[i];
+            m_Stream << "\n" << std::setprecision(std::numeric_limits<double>::max_digits10);
+        }
+        else
+        {
+            const auto column_count = static_cast<uint32_t>(m_Columns.size());
+            m_Stream.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+            m_Stream.write(reinterpret_cast<const char*>(&column_count), sizeof(column_count));
+
+            // Column names are stored as null-terminated strings.
+            for(const auto& column : m_Columns)
+                m_Stream.write(column.c_str(), static_cast<std::streamsize>(column.size() + 1));
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void AsyncCSVLogger::write_records(const size_t start, const size_t count)
+    {
+        const size_t columns = m_Columns.size();
+        const double* records = m_Records.data() + start * columns;
+
+        if(m_Format == Format::CSV)
+        {
+            for(size_t r = 0; r < count; r++, records += columns)
+            {
+                for(size_t c = 0; c < columns; c++)
+                {
+                    if(c > 0) m_Stream << ',';
+                    if(!std::isnan(records[c])) m_Stream << records[c];
+                }
+                m_Stream << '\n';
+            }
+        }
+        else
+        {
+            const auto record_count = static_cast<uint32_t>(count);
+            m_Stream.write(reinterpret_cast<const char*>(&record_count), sizeof(record_count));
+
+            for(size_t c = 0; c < columns; c++)
+            {
+                for(size_t r = 0; r < count; r++)
+                    m_ColumnBuffer[r] = records[r * columns + c];
+
+                m_Stream.write(
+                    reinterpret_cast<const char*>(m_ColumnBuffer.data()),
+                    static_cast<std::streamsize>(count * sizeof(double))
+                );
+            }
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void AsyncCSVLogger::run_writer()
+    {
+        while(true)
+        {
+            // Read the running state first so that a final drain always
+            // happens after the last records were pushed before shutdown.
+            const bool running = m_Running.load(std::memory_order_acquire);
+
+            const size_t tail = m_Tail.load(std::memory_order_relaxed);
+            const size_t head = m_Head.load(std::memory_order_acquire);
+
+            if(head == tail)
+            {
+                if(!running)
+                    break;
+
+                std::this_thread::sleep_for(WRITER_IDLE_PERIOD);
+                continue;
+            }
+
+            // Write out the contiguous run of records, wrapping around next time.
+            const size_t count = head > tail ? head - tail : m_Capacity - tail;
+            write_records(tail, count);
+            if(!m_Stream.good())
+                m_Failed.store(true, std::memory_order_relaxed);
+
+            m_Tail.store((tail + count) % m_Capacity, std::memory_order_release);
+        }
+
+        m_Stream.flush();
+        if(!m_Stream.good())
+            m_Failed.store(true, std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,103 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+namespace lvk
+{
+
+    // Logs fixed-size numeric records without formatting or allocating on the
+    // logging thread. Records are pushed into a lock-free single-producer ring
+    // buffer, which is drained by a background thread that writes the output.
+    class AsyncCSVLogger
+    {
+    public:
+
+        enum class Format
+        {
+            CSV,
+            // Blocks of records stored column by column, each block is a
+            // uint32 record count followed by each column's doubles.
+            BINARY_COLUMNAR
+        };
+
+        AsyncCSVLogger(
+            const std::filesystem::path& path,
+            std::vector<std::string> columns,
+            const Format format = Format::CSV,
+            const size_t capacity = 4096
+        );
+
+        ~AsyncCSVLogger();
+
+        AsyncCSVLogger(const AsyncCSVLogger&) = delete;
+
+        AsyncCSVLogger& operator=(const AsyncCSVLogger&) = delete;
+
+
+        // NOTE: must only be called by a single thread at a time.
+        bool push(std::span<const double> values);
+
+        template<typename... Args>
+        bool log(const Args... values);
+
+        void flush();
+
+
+        const std::vector<std::string>& columns() const;
+
+        size_t dropped_records() const;
+
+        bool has_error() const;
+
+    private:
+
+        void write_header();
+
+        void write_records(const size_t start, const size_t count);
+
+        void run_writer();
+
+    private:
+        std::ofstream m_Stream;
+        Format m_Format;
+
+        std::vector<std::string> m_Columns;
+        std::vector<double> m_Records;
+        std::vector<double> m_ColumnBuffer;
+        size_t m_Capacity;
+
+        alignas(64) std::atomic<size_t> m_Head = 0;
+        alignas(64) std::atomic<size_t> m_Tail = 0;
+        alignas(64) std::atomic<size_t> m_Dropped = 0;
+
+        std::atomic<bool> m_Failed = false;
+        std::atomic<bool> m_Running = true;
+        std::thread m_WriterThread;
+    };
+
+}
+
+#include "AsyncCSVLogger.tpp"
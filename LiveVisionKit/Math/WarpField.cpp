@@ -24,6 +24,7 @@
 #include "Functions/Drawing.hpp"
 #include "Math/VirtualGrid.hpp"
 #include "Timing/Stopwatch.hpp"
+#include "Timing/Tracing.hpp"
 #include "Functions/Image.hpp"
 #include "Functions/Math.hpp"
 #include "Directives.hpp"
@@ -80,6 +81,9 @@ namespace lvk
         cv::Mat new_field;
         cv::resize(m_Offsets, new_field, new_size, 0, 0, cv::INTER_LINEAR);
         m_Offsets = std::move(new_field);
+
+        // The cached field grid no longer matches the field.
+        m_FieldGridCacheScale = {0, 0};
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -211,12 +215,17 @@ namespace lvk
 
     void WarpField::apply(const cv::UMat& src, cv::UMat& dst, const bool high_quality) const
     {
-        if(m_Offsets.size() != MinimumSize)
+        LVK_TRACE("WarpField::apply");
+
+        // NOTE: OpenCV's warps don't support half float frames, so those always use our remap.
+        const bool native_warp = src.depth() != CV_16F;
+
+        if(m_Offsets.size() != MinimumSize || !native_warp)
         {
             // If our field is larger than 2x2 then scale up the field and remap the input.
             cv::resize(m_Offsets, m_WarpMap, src.size(), 0, 0, cv::INTER_LINEAR_EXACT);
 
-            if(!high_quality)
+            if(!high_quality && native_warp)
             {
                 // Convert offsets to an absolute map for the generic remap function.
                 cv::add(m_WarpMap, view_coord_grid_gpu(src.size()), m_WarpMap);
@@ -253,6 +262,34 @@ namespace lvk
         }
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    void WarpField::apply(const cv::UMat& src, cv::UMat& dst, const cv::Size& dst_size) const
+    {
+        LVK_TRACE("WarpField::apply");
+
+        LVK_ASSERT(dst_size.width > 0 && dst_size.height > 0);
+
+        if(dst_size == src.size())
+        {
+            apply(src, dst, true);
+            return;
+        }
+
+        // The field describes the warp in the src frame, so it is sampled at each dst coord's
+        // scaled position in the src frame. As the field spans the whole frame, this is the
+        // same as scaling the field up to the dst size. The scaling is then folded into the
+        // offsets so that the warp and the scaling are both performed in one remap.
+        const float scale_x = static_cast<float>(src.cols) / static_cast<float>(dst_size.width);
+        const float scale_y = static_cast<float>(src.rows) / static_cast<float>(dst_size.height);
+
+        cv::resize(m_Offsets, m_WarpMap, dst_size, 0, 0, cv::INTER_LINEAR_EXACT);
+        cv::multiply(view_coord_grid_gpu(dst_size), cv::Scalar(scale_x - 1.0f, scale_y - 1.0f), m_ScaleMap);
+        cv::add(m_WarpMap, m_ScaleMap, m_WarpMap);
+
+        lvk::remap(src, dst, m_WarpMap, true /* assume yuv */);
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     // TODO: optimize this
@@ -441,6 +478,85 @@ namespace lvk
         m_Offsets = std::move(motions);
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    void WarpField::fit_rows(
+        const cv::Rect2f& described_region,
+        const std::vector<cv::Point2f>& origin_points,
+        const std::vector<cv::Point2f>& warped_points,
+        const Homography& motion
+    )
+    {
+        LVK_ASSERT(origin_points.size() == warped_points.size());
+        LVK_ASSERT(!described_region.empty());
+
+        // A rolling shutter exposes each row of the frame at a slightly different time, so
+        // fast camera motions appear as wobble and skew which no single homography can
+        // describe. Instead, each row of the field is given its own affine correction on
+        // top of the global motion, fitted to the motion residuals of the points around it.
+        // The rows are then interpolated by the field, so only a few rows are required.
+
+        // Weight of the prior towards the global motion, in number of points. This keeps
+        // rows with very few points close to the global motion, instead of over-fitting.
+        constexpr double GLOBAL_PRIOR_WEIGHT = 4.0;
+
+        const Homography inverse_motion = motion.invert();
+        const auto region_offset = described_region.tl();
+        const cv::Size2f region_size = described_region.size();
+
+        const float row_spacing = region_size.height / static_cast<float>(m_Offsets.rows - 1);
+        const float col_spacing = region_size.width / static_cast<float>(m_Offsets.cols - 1);
+        const float center_x = region_offset.x + region_size.width / 2.0f;
+
+        // Find how far the points are from the global motion.
+        thread_local std::vector<cv::Point2f> residuals;
+        residuals.resize(origin_points.size());
+        for(size_t i = 0; i < origin_points.size(); i++)
+            residuals[i] = origin_points[i] - (inverse_motion * warped_points[i]);
+
+        for(int r = 0; r < m_Offsets.rows; r++)
+        {
+            const float row_y = region_offset.y + static_cast<float>(r) * row_spacing;
+
+            // Solve the weighted least squares fit of the row's affine correction. The points
+            // are weighted linearly by their distance to the row, matching the interpolation
+            // between the rows. The coordinates are normalized to keep the system conditioned.
+            cv::Matx33d ata = GLOBAL_PRIOR_WEIGHT * cv::Matx33d::eye();
+            cv::Matx32d atb = cv::Matx32d::zeros();
+            for(size_t i = 0; i < warped_points.size(); i++)
+            {
+                const auto& point = warped_points[i];
+
+                const double weight = 1.0 - std::abs(point.y - row_y) / row_spacing;
+                if(weight <= 0.0) continue;
+
+                const cv::Vec3d a(
+                    (point.x - center_x) / region_size.width,
+                    (point.y - row_y) / row_spacing,
+                    1.0
+                );
+
+                ata += weight * (a * a.t());
+                atb += weight * (a * cv::Matx12d(residuals[i].x, residuals[i].y));
+            }
+
+            cv::Matx32d correction;
+            cv::solve(ata, atb, correction, cv::DECOMP_CHOLESKY);
+
+            auto* row_offsets = m_Offsets.ptr<cv::Point2f>(r);
+            for(int c = 0; c < m_Offsets.cols; c++)
+            {
+                const cv::Point2f sample_point(region_offset.x + static_cast<float>(c) * col_spacing, row_y);
+                const double u = (sample_point.x - center_x) / region_size.width;
+
+                row_offsets[c] = (inverse_motion * sample_point) - sample_point + cv::Point2f(
+                    static_cast<float>(u * correction(0, 0) + correction(2, 0)),
+                    static_cast<float>(u * correction(0, 1) + correction(2, 1))
+                );
+            }
+        }
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void WarpField::set_identity()
@@ -574,6 +690,34 @@ namespace lvk
         cv::scaleAdd(field.m_Offsets, scaling, m_Offsets, m_Offsets);
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    void WarpField::compose(const WarpField& first, const cv::Size2f& field_scale)
+    {
+        LVK_ASSERT(field_scale.width > 0 && field_scale.height > 0);
+
+        // Use the finer of the two resolutions, so no detail is lost from either field.
+        resize(cv::Size(std::max(cols(), first.cols()), std::max(rows(), first.rows())));
+
+        // Each dst coord samples the intermediate frame at its coord plus our offset, which
+        // in turn samples the src at that position plus the first field's offset there.
+        // So the first field must be sampled at our displaced positions, which are found
+        // in the first field's coordinate space, then added on to our offsets.
+        cv::add(m_Offsets, view_field_coord_grid(field_scale), m_ResultsBuffer);
+        cv::multiply(
+            m_ResultsBuffer,
+            cv::Scalar(
+                static_cast<float>(first.cols() - 1) / field_scale.width,
+                static_cast<float>(first.rows() - 1) / field_scale.height
+            ),
+            m_ResultsBuffer
+        );
+
+        cv::Mat first_offsets;
+        cv::remap(first.m_Offsets, first_offsets, m_ResultsBuffer, cv::noArray(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+        cv::add(m_Offsets, first_offsets, m_Offsets);
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     // NOTE: This returns a view into a shared cache, do not modify the value.
@@ -823,6 +967,15 @@ namespace lvk
         return field / scaling;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    WarpField compose(const WarpField& first, const WarpField& second, const cv::Size2f& field_scale)
+    {
+        WarpField result(second);
+        result.compose(first, field_scale);
+        return result;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     WarpField operator*(const WarpField& field, const float scaling)
@@ -67,6 +67,9 @@ namespace lvk
 
         void apply(const cv::UMat& src, cv::UMat& dst, const bool high_quality = true) const;
 
+        // Warps and scales the src into a dst of the given size, with a single resample.
+        void apply(const cv::UMat& src, cv::UMat& dst, const cv::Size& dst_size) const;
+
         void draw(cv::UMat& dst, const cv::Scalar& color = yuv::MAGENTA, const int thickness = 2) const;
 
 
@@ -88,6 +91,15 @@ namespace lvk
             const std::optional<Homography>& motion_hint
         );
 
+        // Fits a rolling shutter motion model, in which each row of the field follows
+        // the global motion plus its own affine correction, fitted to the nearby points.
+        void fit_rows(
+            const cv::Rect2f& described_region,
+            const std::vector<cv::Point2f>& origin_points,
+            const std::vector<cv::Point2f>& warped_points,
+            const Homography& motion
+        );
+
 
         void set_identity();
 
@@ -118,6 +130,11 @@ namespace lvk
 
         void combine(const WarpField& field, const float scaling = 1.0f);
 
+        // Composes the field onto the given field, which is warped first, so that applying
+        // the result is equivalent to applying both fields in sequence. Unlike combine(),
+        // the field is sampled at the displaced positions, giving a true warp of a warp.
+        void compose(const WarpField& first, const cv::Size2f& field_scale);
+
 
         WarpField& operator=(WarpField&& other) noexcept;
 
@@ -161,6 +178,7 @@ namespace lvk
         mutable cv::Mat m_FieldGridCache;
         mutable cv::Size2f m_FieldGridCacheScale = {0, 0};
         mutable cv::UMat m_WarpMap{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
+        mutable cv::UMat m_ScaleMap{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
     };
 
     WarpField operator+(const WarpField& left, const WarpField& right);
@@ -169,6 +187,9 @@ namespace lvk
 
     WarpField operator*(const WarpField& left, const WarpField& right);
 
+    // Returns the field equivalent to applying the first field, followed by the second.
+    WarpField compose(const WarpField& first, const WarpField& second, const cv::Size2f& field_scale);
+
 
     WarpField operator+(const WarpField& left, const cv::Point2f& right);
 
@@ -0,0 +1,453 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "FrameSpool.hpp"
+
+#include <limits>
+#include <cstring>
+
+#include "Directives.hpp"
+#include "Functions/OpenCL/Kernels.hpp"
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    constexpr uint64_t NO_SEQUENCE = std::numeric_limits<uint64_t>::max();
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    // Backing memory for the spooled frames. Mapped file regions fall back
+    // to host memory if the temporary file could not be created or mapped.
+    struct SpoolRegion
+    {
+        uint8_t* data = nullptr;
+        size_t bytes = 0;
+
+        // NOTE: regions can exceed 2GB, which is more than a cv::Mat row can address.
+        std::unique_ptr<uint8_t[]> host_buffer;
+#ifdef WIN32
+        HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#else
+        std::FILE* file = nullptr;
+#endif
+
+        SpoolRegion(const size_t bytes, const FrameStorage storage)
+            : bytes(bytes)
+        {
+            if(storage == FrameStorage::MAPPED_FILE && map_file())
+                return;
+
+            host_buffer.reset(new uint8_t[bytes]);
+            data = host_buffer.get();
+        }
+
+        ~SpoolRegion()
+        {
+#ifdef WIN32
+            if(mapping != nullptr)
+            {
+                UnmapViewOfFile(data);
+                CloseHandle(mapping);
+            }
+            if(file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+#else
+            if(file != nullptr)
+            {
+                if(data != nullptr) munmap(data, bytes);
+                std::fclose(file);
+            }
+#endif
+        }
+
+        bool map_file()
+        {
+#ifdef WIN32
+            wchar_t directory[MAX_PATH], path[MAX_PATH];
+            if(GetTempPathW(MAX_PATH, directory) == 0 || GetTempFileNameW(directory, L"lvk", 0, path) == 0)
+                return false;
+
+            // NOTE: the file is deleted by the OS once its last handle is closed.
+            file = CreateFileW(
+                path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr
+            );
+            if(file == INVALID_HANDLE_VALUE)
+                return false;
+
+            const auto size = static_cast<uint64_t>(bytes);
+            mapping = CreateFileMappingW(
+                file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr
+            );
+            if(mapping == nullptr)
+                return false;
+
+            data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+            return data != nullptr;
+#else
+            // NOTE: the file is deleted by the OS once it is closed.
+            file = std::tmpfile();
+            if(file == nullptr || ftruncate(fileno(file), static_cast<off_t>(bytes)) != 0)
+                return false;
+
+            void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+            if(region == MAP_FAILED)
+                return false;
+
+            data = static_cast<uint8_t*>(region);
+            return true;
+#endif
+        }
+    };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    FrameSpool::FrameSpool(const size_t capacity, const FrameStorage storage)
+        : m_Storage(storage),
+          m_Capacity(capacity),
+          m_DeviceQueue(capacity),
+          m_Slots(capacity),
+          m_CurrentSequence(NO_SEQUENCE),
+          m_PrefetchSequence(NO_SEQUENCE)
+    {
+        LVK_ASSERT(capacity > 0);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    FrameSpool::~FrameSpool()
+    {
+        if(!m_TransferThread.joinable())
+            return;
+
+        {
+            std::unique_lock<std::mutex> transfer_lock(m_TransferMutex);
+            m_StopTransfers = true;
+            m_TransferFlag.notify_all();
+        }
+        m_TransferThread.join();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::push(Frame&& frame)
+    {
+        if(m_Storage == FrameStorage::DEVICE)
+        {
+            m_DeviceQueue.push(std::move(frame));
+            return;
+        }
+
+        // Grow the slots whenever we see a larger frame, so no frame is ever truncated.
+        const size_t frame_bytes = frame.data.total() * frame.data.elemSize();
+        if(m_Region == nullptr || frame_bytes > m_SlotBytes)
+            reallocate(m_Capacity, frame_bytes);
+
+        download(std::move(frame), m_NextSequence++);
+        m_Size = std::min(m_Size + 1, m_Capacity);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    Frame& FrameSpool::oldest()
+    {
+        LVK_ASSERT(!is_empty());
+
+        if(m_Storage == FrameStorage::DEVICE)
+            return m_DeviceQueue.oldest();
+
+        // The oldest frame should have already been prefetched onto the device
+        // the last time this was called, in which case we just need to swap it
+        // in. Otherwise, it's uploaded on demand.
+        const uint64_t sequence = m_NextSequence - m_Size;
+        if(m_CurrentSequence != sequence)
+        {
+            if(m_PrefetchSequence == sequence)
+            {
+                wait_for_transfer(m_PrefetchTransfer);
+                std::swap(m_CurrentFrame, m_PrefetchFrame);
+                m_PrefetchSequence = NO_SEQUENCE;
+            }
+            else upload(sequence, m_CurrentFrame);
+
+            m_CurrentSequence = sequence;
+        }
+
+        // Prefetch the frame which will be the oldest after the next push. This is
+        // uploaded into new data on the transfer thread, as the old frame may still
+        // be in use by work queued on the caller's queue.
+        if(m_Size > 1 && m_PrefetchSequence != sequence + 1)
+        {
+            wait_for_transfer(m_PrefetchTransfer);
+            m_PrefetchFrame.release();
+            m_PrefetchFrame.timestamp = m_Slots[(sequence + 1) % m_Capacity].timestamp;
+
+            m_PrefetchTransfer = queue_transfer([this, slot = slot_data(sequence + 1)](){
+                slot.copyTo(m_PrefetchFrame.data);
+            });
+            m_PrefetchSequence = sequence + 1;
+        }
+
+        return m_CurrentFrame;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::skip(const size_t amount)
+    {
+        if(m_Storage == FrameStorage::DEVICE)
+            m_DeviceQueue.skip(amount);
+        else
+            m_Size -= std::min(amount, m_Size);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::resize(const size_t capacity)
+    {
+        LVK_ASSERT(capacity > 0);
+
+        if(capacity == m_Capacity)
+            return;
+
+        m_DeviceQueue.resize(capacity);
+
+        if(m_Region != nullptr)
+            reallocate(capacity, m_SlotBytes);
+        else
+        {
+            m_Slots.resize(capacity);
+            m_Capacity = capacity;
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::set_storage(const FrameStorage storage)
+    {
+        if(storage == m_Storage)
+            return;
+
+        // NOTE: existing frames are not migrated between storages.
+        wait_for_transfers();
+        clear();
+        m_Region.reset();
+        m_SlotBytes = 0;
+        m_CurrentFrame.release();
+        m_PrefetchFrame.release();
+
+        m_Storage = storage;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::clear()
+    {
+        m_DeviceQueue.clear();
+
+        m_Size = 0;
+        m_CurrentSequence = NO_SEQUENCE;
+        m_PrefetchSequence = NO_SEQUENCE;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool FrameSpool::is_full() const
+    {
+        return size() == capacity();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool FrameSpool::is_empty() const
+    {
+        return size() == 0;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t FrameSpool::size() const
+    {
+        return m_Storage == FrameStorage::DEVICE ? m_DeviceQueue.size() : m_Size;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t FrameSpool::capacity() const
+    {
+        return m_Capacity;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    FrameStorage FrameSpool::storage() const
+    {
+        return m_Storage;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    cv::Mat FrameSpool::slot_data(const uint64_t sequence)
+    {
+        const size_t slot = sequence % m_Capacity;
+        const auto& info = m_Slots[slot];
+
+        return cv::Mat(info.size, info.type, m_Region->data + slot * m_SlotBytes);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::reallocate(const size_t capacity, const size_t slot_bytes)
+    {
+        wait_for_transfers();
+
+        auto region = std::make_unique<SpoolRegion>(capacity * slot_bytes, m_Storage);
+        std::vector<SlotInfo> slots(capacity);
+
+        // Migrate over the newest frames which still fit in the new capacity.
+        const size_t kept_frames = std::min(m_Size, capacity);
+        for(uint64_t sequence = m_NextSequence - kept_frames; sequence < m_NextSequence; sequence++)
+        {
+            const size_t old_slot = sequence % m_Capacity, new_slot = sequence % capacity;
+            const auto& info = m_Slots[old_slot];
+
+            slots[new_slot] = info;
+            std::memcpy(
+                region->data + new_slot * slot_bytes,
+                m_Region->data + old_slot * m_SlotBytes,
+                static_cast<size_t>(info.size.area()) * CV_ELEM_SIZE(info.type)
+            );
+        }
+
+        m_Region = std::move(region);
+        m_Slots = std::move(slots);
+        m_SlotBytes = slot_bytes;
+        m_Capacity = capacity;
+        m_Size = kept_frames;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::download(Frame&& frame, const uint64_t sequence)
+    {
+        auto& info = m_Slots[sequence % m_Capacity];
+        info.size = frame.size();
+        info.type = frame.type();
+        info.timestamp = frame.timestamp;
+
+        cv::Mat slot = slot_data(sequence);
+
+        // The frame may still be in flight on the caller's queue, so the transfer thread
+        // waits on a marker queued behind it. Without markers, we must transfer it here.
+        auto marker = ocl::queue_marker();
+        if(marker == nullptr && cv::ocl::useOpenCL())
+        {
+            frame.data.copyTo(slot);
+            info.transfer = 0;
+            return;
+        }
+
+        info.transfer = queue_transfer([data = std::move(frame.data), slot, marker](){
+            ocl::wait_for_marker(marker);
+            data.copyTo(slot);
+        });
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::upload(const uint64_t sequence, Frame& frame)
+    {
+        const auto& info = m_Slots[sequence % m_Capacity];
+        wait_for_transfer(info.transfer);
+
+        slot_data(sequence).copyTo(frame.data);
+        frame.timestamp = info.timestamp;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t FrameSpool::queue_transfer(std::function<void()>&& transfer)
+    {
+        if(!m_TransferThread.joinable())
+            m_TransferThread = std::thread(&FrameSpool::run_transfers, this);
+
+        std::unique_lock<std::mutex> transfer_lock(m_TransferMutex);
+        m_Transfers.push_back(std::move(transfer));
+        m_TransferFlag.notify_all();
+
+        return ++m_TransfersQueued;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::wait_for_transfer(const uint64_t transfer)
+    {
+        std::unique_lock<std::mutex> transfer_lock(m_TransferMutex);
+        while(m_TransfersCompleted < transfer)
+            m_TransferFlag.wait(transfer_lock);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::wait_for_transfers()
+    {
+        wait_for_transfer(m_TransfersQueued);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameSpool::run_transfers()
+    {
+        std::unique_lock<std::mutex> transfer_lock(m_TransferMutex);
+        while(true)
+        {
+            while(m_Transfers.empty() && !m_StopTransfers)
+                m_TransferFlag.wait(transfer_lock);
+
+            if(m_Transfers.empty())
+                return;
+
+            auto transfer = std::move(m_Transfers.front());
+            m_Transfers.pop_front();
+
+            // NOTE: uploads must be complete before the frames are used on another queue.
+            transfer_lock.unlock();
+            transfer();
+            if(cv::ocl::useOpenCL())
+                cv::ocl::finish();
+            transfer_lock.lock();
+
+            m_TransfersCompleted++;
+            m_TransferFlag.notify_all();
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,134 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <opencv2/opencv.hpp>
+
+#include "Filters/VideoFrame.hpp"
+#include "Structures/StreamBuffer.hpp"
+
+namespace lvk
+{
+
+    enum class FrameStorage
+    {
+        DEVICE,
+        HOST,
+        MAPPED_FILE
+    };
+
+    struct SpoolRegion;
+
+    // A fixed capacity frame queue which can spill its frames out of device memory, into
+    // host memory or a memory-mapped temporary file. Only the oldest frame, along with a
+    // prefetch of the frame after it, is kept on the device regardless of the capacity.
+    // Spilled frames are transferred on a separate thread, off the caller's queue.
+    class FrameSpool
+    {
+    public:
+
+        explicit FrameSpool(const size_t capacity, const FrameStorage storage = FrameStorage::DEVICE);
+
+        ~FrameSpool();
+
+        FrameSpool(const FrameSpool&) = delete;
+
+        FrameSpool& operator=(const FrameSpool&) = delete;
+
+
+        // NOTE: pushing onto a full spool overwrites the oldest frame.
+        void push(Frame&& frame);
+
+        Frame& oldest();
+
+        void skip(const size_t amount);
+
+
+        void resize(const size_t capacity);
+
+        void set_storage(const FrameStorage storage);
+
+        void clear();
+
+
+        bool is_full() const;
+
+        bool is_empty() const;
+
+        size_t size() const;
+
+        size_t capacity() const;
+
+        FrameStorage storage() const;
+
+    private:
+
+        struct SlotInfo
+        {
+            cv::Size size;
+            int type = 0;
+            uint64_t timestamp = 0;
+            uint64_t transfer = 0;
+        };
+
+        cv::Mat slot_data(const uint64_t sequence);
+
+        void reallocate(const size_t capacity, const size_t slot_bytes);
+
+        void download(Frame&& frame, const uint64_t sequence);
+
+        void upload(const uint64_t sequence, Frame& frame);
+
+        uint64_t queue_transfer(std::function<void()>&& transfer);
+
+        void wait_for_transfer(const uint64_t transfer);
+
+        void wait_for_transfers();
+
+        void run_transfers();
+
+    private:
+        FrameStorage m_Storage;
+        size_t m_Capacity, m_Size = 0;
+        uint64_t m_NextSequence = 0;
+
+        StreamBuffer<Frame> m_DeviceQueue;
+
+        std::unique_ptr<SpoolRegion> m_Region;
+        std::vector<SlotInfo> m_Slots;
+        size_t m_SlotBytes = 0;
+
+        Frame m_CurrentFrame, m_PrefetchFrame;
+        uint64_t m_CurrentSequence, m_PrefetchSequence;
+        uint64_t m_PrefetchTransfer = 0;
+
+        std::thread m_TransferThread;
+        std::mutex m_TransferMutex;
+        std::condition_variable m_TransferFlag;
+        std::deque<std::function<void()>> m_Transfers;
+        uint64_t m_TransfersQueued = 0, m_TransfersCompleted = 0;
+        bool m_StopTransfers = false;
+    };
+
+}
@@ -0,0 +1,252 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "LatencyHistogram.hpp"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+#include "Directives.hpp"
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    LatencyHistogram::LatencyHistogram()
+    {
+        reset();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    LatencyHistogram::LatencyHistogram(const LatencyHistogram& other)
+        : LatencyHistogram()
+    {
+        merge(other);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other)
+    {
+        if(this != &other)
+        {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void LatencyHistogram::record(const Time& time)
+    {
+        const auto nanoseconds = static_cast<uint64_t>(std::max(time.nanoseconds(), 0.0));
+
+        // NOTE: all updates are relaxed atomics, so recording is lock-free and wait-free
+        // apart from the min/max updates, which only retry while they are being raced.
+        m_Buckets[bucket_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        m_Total.fetch_add(nanoseconds, std::memory_order_relaxed);
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t current_min = m_Min.load(std::memory_order_relaxed);
+        while(nanoseconds < current_min && !m_Min.compare_exchange_weak(current_min, nanoseconds, std::memory_order_relaxed));
+
+        uint64_t current_max = m_Max.load(std::memory_order_relaxed);
+        while(nanoseconds > current_max && !m_Max.compare_exchange_weak(current_max, nanoseconds, std::memory_order_relaxed));
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        for(size_t i = 0; i < m_BucketCount; i++)
+        {
+            const auto bucket_count = other.m_Buckets[i].load(std::memory_order_relaxed);
+            if(bucket_count > 0)
+                m_Buckets[i].fetch_add(bucket_count, std::memory_order_relaxed);
+        }
+
+        m_Count.fetch_add(other.m_Count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_Total.fetch_add(other.m_Total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        const uint64_t other_min = other.m_Min.load(std::memory_order_relaxed);
+        uint64_t current_min = m_Min.load(std::memory_order_relaxed);
+        while(other_min < current_min && !m_Min.compare_exchange_weak(current_min, other_min, std::memory_order_relaxed));
+
+        const uint64_t other_max = other.m_Max.load(std::memory_order_relaxed);
+        uint64_t current_max = m_Max.load(std::memory_order_relaxed);
+        while(other_max > current_max && !m_Max.compare_exchange_weak(current_max, other_max, std::memory_order_relaxed));
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void LatencyHistogram::reset()
+    {
+        for(auto& bucket : m_Buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        m_Count.store(0, std::memory_order_relaxed);
+        m_Total.store(0, std::memory_order_relaxed);
+        m_Min.store(UINT64_MAX, std::memory_order_relaxed);
+        m_Max.store(0, std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t LatencyHistogram::count() const
+    {
+        return m_Count.load(std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    Time LatencyHistogram::min() const
+    {
+        return count() == 0 ? Time(0) : Time(m_Min.load(std::memory_order_relaxed));
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    Time LatencyHistogram::max() const
+    {
+        return Time(m_Max.load(std::memory_order_relaxed));
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    Time LatencyHistogram::mean() const
+    {
+        const auto total_count = count();
+        return total_count == 0 ? Time(0) : Time(m_Total.load(std::memory_order_relaxed) / total_count);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    Time LatencyHistogram::percentile(const double percent) const
+    {
+        LVK_ASSERT(percent >= 0.0 && percent <= 100.0);
+
+        const auto total_count = count();
+        if(total_count == 0)
+            return Time(0);
+
+        // Find the bucket which holds the requested rank.
+        const auto rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(total_count)))
+        );
+
+        const uint64_t min_value = m_Min.load(std::memory_order_relaxed);
+        const uint64_t max_value = m_Max.load(std::memory_order_relaxed);
+
+        uint64_t cumulative_count = 0;
+        for(size_t i = 0; i < m_BucketCount; i++)
+        {
+            cumulative_count += m_Buckets[i].load(std::memory_order_relaxed);
+            if(cumulative_count >= rank)
+            {
+                // Report the middle of the bucket, bounded by the actual extremes.
+                const uint64_t midpoint = bucket_lower_bound(i) + (bucket_upper_bound(i) - bucket_lower_bound(i)) / 2;
+                return Time(std::clamp(midpoint, min_value, max_value));
+            }
+        }
+        return max();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void LatencyHistogram::write_to(Logger& logger, const bool header) const
+    {
+        // Format is..
+        // 1. Bucket lower bound (ms)
+        // 2. Bucket upper bound (ms)
+        // 3. Bucket count
+        // 4. Cumulative percentile
+
+        if(header)
+        {
+            logger << "Lower Bound (ms)" << "Upper Bound (ms)" << "Count" << "Percentile";
+            logger.next();
+        }
+
+        const auto total_count = count();
+        uint64_t cumulative_count = 0;
+        for(size_t i = 0; i < m_BucketCount; i++)
+        {
+            const auto bucket_count = m_Buckets[i].load(std::memory_order_relaxed);
+            if(bucket_count == 0)
+                continue;
+
+            cumulative_count += bucket_count;
+
+            logger << Time(bucket_lower_bound(i)).milliseconds();
+            logger << Time(bucket_upper_bound(i)).milliseconds();
+            logger << bucket_count;
+            logger << 100.0 * static_cast<double>(cumulative_count) / static_cast<double>(total_count);
+            logger.next();
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t LatencyHistogram::bucket_of(const uint64_t nanoseconds)
+    {
+        // Values below the sub-bucket count are recorded exactly.
+        if(nanoseconds < m_SubBuckets)
+            return static_cast<size_t>(nanoseconds);
+
+        // Values beyond the largest magnitude are saturated into the last bucket.
+        const uint64_t magnitude = std::bit_width(nanoseconds) - 1;
+        if(magnitude > m_MaxMagnitude)
+            return m_BucketCount - 1;
+
+        // The top sub-bucket bits below the leading one give the linear position in the magnitude.
+        const uint64_t shift = magnitude - m_SubBucketBits;
+        const uint64_t sub_bucket = (nanoseconds >> shift) - m_SubBuckets;
+
+        return static_cast<size_t>(m_SubBuckets + shift * m_SubBuckets + sub_bucket);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t LatencyHistogram::bucket_lower_bound(const size_t bucket)
+    {
+        if(bucket < m_SubBuckets)
+            return bucket;
+
+        const uint64_t shift = (bucket - m_SubBuckets) / m_SubBuckets;
+        const uint64_t sub_bucket = (bucket - m_SubBuckets) % m_SubBuckets;
+
+        return (m_SubBuckets + sub_bucket) << shift;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t LatencyHistogram::bucket_upper_bound(const size_t bucket)
+    {
+        if(bucket < m_SubBuckets)
+            return bucket + 1;
+
+        const uint64_t shift = (bucket - m_SubBuckets) / m_SubBuckets;
+        return bucket_lower_bound(bucket) + (uint64_t{1} << shift);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
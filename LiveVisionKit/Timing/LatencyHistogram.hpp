@@ -0,0 +1,83 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Time.hpp"
+#include "Logging/Logger.hpp"
+
+namespace lvk
+{
+
+    // Fixed memory log-linear histogram of time measurements. Each power of two
+    // is split into linear sub-buckets so that any recorded time is resolved to
+    // within ~3% of its true value, from nanoseconds up to several days.
+    class LatencyHistogram
+    {
+    public:
+
+        LatencyHistogram();
+
+        LatencyHistogram(const LatencyHistogram& other);
+
+        LatencyHistogram& operator=(const LatencyHistogram& other);
+
+
+        void record(const Time& time);
+
+        void merge(const LatencyHistogram& other);
+
+        void reset();
+
+
+        uint64_t count() const;
+
+        Time min() const;
+
+        Time max() const;
+
+        Time mean() const;
+
+        Time percentile(const double percent) const;
+
+
+        void write_to(Logger& logger, const bool header = true) const;
+
+    private:
+
+        static size_t bucket_of(const uint64_t nanoseconds);
+
+        static uint64_t bucket_lower_bound(const size_t bucket);
+
+        static uint64_t bucket_upper_bound(const size_t bucket);
+
+    private:
+        constexpr static uint64_t m_SubBucketBits = 5;
+        constexpr static uint64_t m_SubBuckets = uint64_t{1} << m_SubBucketBits;
+        constexpr static uint64_t m_MaxMagnitude = 50;
+        constexpr static size_t m_BucketCount = m_SubBuckets * (m_MaxMagnitude - m_SubBucketBits + 2);
+
+        std::array<std::atomic<uint64_t>, m_BucketCount> m_Buckets;
+        std::atomic<uint64_t> m_Count = 0, m_Total = 0;
+        std::atomic<uint64_t> m_Min = UINT64_MAX, m_Max = 0;
+    };
+
+}
@@ -18,13 +18,18 @@
 
 #include "Directives.hpp"
 #include "Functions/Container.hpp"
+#include "Functions/OpenCL/Kernels.hpp"
 
 #include <opencv2/core/ocl.hpp>
+#include <algorithm>
 #include <thread>
 
 namespace lvk
 {
 
+    // Bounds the number of measurements that may await their GPU markers.
+    constexpr size_t MAX_PENDING_TIMES = 64;
+
 //---------------------------------------------------------------------------------------------------------------------
 
 	Stopwatch::Stopwatch(const size_t history)
@@ -41,8 +46,12 @@ namespace lvk
 
 	void Stopwatch::start()
 	{
+        // NOTE: markers are only resolved by the owning thread, so the accessors stay read-only.
+        resolve_markers();
+
 		m_Running = true;
 		m_StartTime = Time::Now();
+        m_StartMarker = take_marker();
 	}
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -53,13 +62,29 @@ namespace lvk
         if(is_running() || is_paused())
         {
             m_ElapsedTime = pause();
-            m_History.push(m_ElapsedTime);
 
+            // Measurements which depend on GPU markers can only be
+            // added to the history once all their markers complete.
+            const bool has_markers = std::any_of(m_Segments.begin(), m_Segments.end(), [](const Segment& segment){
+                return segment.start_marker != nullptr || segment.end_marker != nullptr;
+            });
+
+            if(has_markers)
+                m_PendingTimes.push_back(std::move(m_Segments));
+            else
+            {
+                m_History.push(m_ElapsedTime);
+                m_Histogram.record(m_ElapsedTime);
+            }
+
+            m_Segments.clear();
             m_Memory = Time(0);
 
+            resolve_markers();
             return m_ElapsedTime;
         }
 
+        m_SyncRequested = false;
         return Time(0);
 	}
 
@@ -70,9 +95,16 @@ namespace lvk
         // If paused, returns the last pause time.
         // If stopped, returns zero as memory should be reset.
         if(!is_running())
+        {
+            m_SyncRequested = false;
             return m_Memory;
+        }
 
-        m_Memory += (Time::Now() - m_StartTime);
+        const Time end_time = Time::Now();
+        m_Segments.push_back({m_StartTime, end_time, std::move(m_StartMarker), take_marker()});
+        m_StartMarker = nullptr;
+
+        m_Memory += (end_time - m_StartTime);
         m_ElapsedTime = m_Memory;
         m_Running = false;
 
@@ -112,10 +144,73 @@ namespace lvk
 
     Stopwatch& Stopwatch::sync_gpu(const bool trigger)
     {
-        if(trigger) cv::ocl::finish();
+        // If supported, the next start or stop is timed by a queue marker which
+        // resolves asynchronously once the GPU reaches it. Otherwise, we have to
+        // fall back to draining the entire queue before taking the time.
+        if(trigger)
+        {
+            if(ocl::supports_markers())
+                m_SyncRequested = true;
+            else
+                cv::ocl::finish();
+        }
         return *this;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    Stopwatch::Marker Stopwatch::take_marker()
+    {
+        if(!m_SyncRequested)
+            return nullptr;
+
+        m_SyncRequested = false;
+        return ocl::queue_marker();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void Stopwatch::resolve_markers()
+    {
+        // NOTE: the OpenCL queue is in-order, so measurements resolve in order.
+        while(!m_PendingTimes.empty())
+        {
+            bool resolved = true;
+            Time total_time(0);
+            for(const auto& segment : m_PendingTimes.front())
+            {
+                const uint64_t start = segment.start_marker != nullptr ? segment.start_marker->load()
+                                                                       : static_cast<uint64_t>(segment.start.nanoseconds());
+
+                const uint64_t end = segment.end_marker != nullptr ? segment.end_marker->load()
+                                                                   : static_cast<uint64_t>(segment.end.nanoseconds());
+
+                // Markers remain zero until the GPU has reached them.
+                if(start == 0 || end == 0)
+                {
+                    resolved = false;
+                    break;
+                }
+
+                if(end > start)
+                    total_time += Time(end - start);
+            }
+
+            if(resolved)
+            {
+                m_History.push(total_time);
+                m_Histogram.record(total_time);
+                m_PendingTimes.pop_front();
+            }
+            else if(m_PendingTimes.size() > MAX_PENDING_TIMES)
+            {
+                // We've been waiting for too long, so give up on the oldest.
+                m_PendingTimes.pop_front();
+            }
+            else return;
+        }
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
 	bool Stopwatch::is_running() const
@@ -173,11 +268,20 @@ namespace lvk
 		return m_History;
 	}
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    const LatencyHistogram& Stopwatch::histogram() const
+    {
+        return m_Histogram;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void Stopwatch::reset_history()
     {
         m_History.clear();
+        m_Histogram.reset();
+        m_PendingTimes.clear();
     }
 
 //---------------------------------------------------------------------------------------------------------------------
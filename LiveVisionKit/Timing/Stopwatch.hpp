@@ -16,7 +16,13 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <vector>
+
 #include "Time.hpp"
+#include "LatencyHistogram.hpp"
 #include "Structures/StreamBuffer.hpp"
 
 namespace lvk
@@ -52,12 +58,33 @@ namespace lvk
 
 		const StreamBuffer<Time>& history() const;
 
+        const LatencyHistogram& histogram() const;
+
         void reset_history();
 
 	private:
-        bool m_Running = false;
+
+        using Marker = std::shared_ptr<std::atomic<uint64_t>>;
+
+        struct Segment
+        {
+            Time start, end;
+            Marker start_marker, end_marker;
+        };
+
+        Marker take_marker();
+
+        void resolve_markers();
+
+	private:
+        bool m_Running = false, m_SyncRequested = false;
 		StreamBuffer<Time> m_History;
+        LatencyHistogram m_Histogram;
 		Time m_ElapsedTime, m_StartTime, m_Memory;
+
+        Marker m_StartMarker;
+        std::vector<Segment> m_Segments;
+        std::deque<std::vector<Segment>> m_PendingTimes;
 	};
 
 }
@@ -0,0 +1,360 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "Tracing.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include "Time.hpp"
+
+namespace lvk::trace
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    struct TraceEvent
+    {
+        constexpr static size_t MaxNameLength = 39;
+
+        uint64_t timestamp;
+        const char* category;
+        char phase;
+        char name[MaxNameLength + 1];
+    };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(const uint32_t thread_id)
+            : thread_id(thread_id)
+        {}
+
+        // NOTE: only the owning thread writes events, so publishing each
+        // event is a single release store of the size. Readers only ever
+        // look at the events below the size they have acquired. The events
+        // are only allocated once the thread first records while tracing
+        // is enabled, so naming a thread or ending a trace costs no memory.
+        std::unique_ptr<TraceEvent[]> events;
+        size_t capacity = 0;
+        std::atomic<size_t> size = 0;
+        std::atomic<size_t> dropped = 0;
+
+        const uint32_t thread_id;
+        std::string thread_name;
+        bool exited = false;
+    };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    struct BufferOwner
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~BufferOwner();
+    };
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static std::atomic<bool> tracing_enabled = false;
+    static std::atomic<size_t> buffer_capacity = 1 << 16;
+    static std::atomic<uint64_t> trace_epoch = 0;
+
+    static std::mutex registry_mutex;
+    static std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers;
+    static uint32_t next_thread_id = 1;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    BufferOwner::~BufferOwner()
+    {
+        // Buffers are shared with the registry so that they outlive their threads,
+        // they are only pruned once their events have been written or cleared.
+        if(buffer != nullptr)
+        {
+            std::scoped_lock lock(registry_mutex);
+            buffer->exited = true;
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void prune_exited_buffers()
+    {
+        // NOTE: the registry mutex must be held by the caller.
+        std::erase_if(thread_buffers, [](const std::shared_ptr<ThreadBuffer>& buffer){
+            return buffer->exited;
+        });
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static ThreadBuffer& local_buffer()
+    {
+        thread_local BufferOwner owner;
+        if(owner.buffer == nullptr)
+        {
+            std::scoped_lock lock(registry_mutex);
+            owner.buffer = std::make_shared<ThreadBuffer>(next_thread_id++);
+            thread_buffers.push_back(owner.buffer);
+        }
+        return *owner.buffer;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void record(const char phase, const char* name, const size_t name_length, const char* category)
+    {
+        auto& buffer = local_buffer();
+
+        if(buffer.events == nullptr)
+        {
+            // An end event without any recorded events has nothing to close.
+            if(phase != 'B') return;
+
+            std::scoped_lock lock(registry_mutex);
+            buffer.capacity = buffer_capacity.load(std::memory_order_relaxed);
+            buffer.events = std::make_unique<TraceEvent[]>(buffer.capacity);
+        }
+
+        const size_t index = buffer.size.load(std::memory_order_relaxed);
+        if(index >= buffer.capacity)
+        {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto& event = buffer.events[index];
+        event.timestamp = static_cast<uint64_t>(Time::Now().nanoseconds());
+        event.category = category;
+        event.phase = phase;
+
+        const size_t length = std::min(name_length, TraceEvent::MaxNameLength);
+        std::memcpy(event.name, name, length);
+        event.name[length] = '\0';
+
+        buffer.size.store(index + 1, std::memory_order_release);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void start(const size_t events_per_thread)
+    {
+        buffer_capacity.store(std::max<size_t>(events_per_thread, 1), std::memory_order_relaxed);
+
+        uint64_t expected_epoch = 0;
+        trace_epoch.compare_exchange_strong(expected_epoch, static_cast<uint64_t>(Time::Now().nanoseconds()));
+
+        tracing_enabled.store(true, std::memory_order_release);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void stop()
+    {
+        tracing_enabled.store(false, std::memory_order_release);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool is_enabled()
+    {
+        return tracing_enabled.load(std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void clear()
+    {
+        // NOTE: this should only be called while tracing is stopped,
+        // otherwise threads may still be writing into their buffers.
+        std::scoped_lock lock(registry_mutex);
+        prune_exited_buffers();
+        for(auto& buffer : thread_buffers)
+        {
+            buffer->size.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+        trace_epoch.store(0, std::memory_order_relaxed);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void name_thread(const std::string& name)
+    {
+        auto& buffer = local_buffer();
+
+        std::scoped_lock lock(registry_mutex);
+        buffer.thread_name = name;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void begin(const char* name, const char* category)
+    {
+        if(is_enabled())
+            record('B', name, std::strlen(name), category);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void begin(const std::string& name, const char* category)
+    {
+        if(is_enabled())
+            record('B', name.c_str(), name.size(), category);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void end()
+    {
+        // NOTE: end events are always recorded so that every begun trace is closed,
+        // even if tracing was stopped while the trace was in progress.
+        record('E', "", 0, "");
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    static void write_json_string(std::ostream& stream, const char* text)
+    {
+        stream << '"';
+        for(; *text != '\0'; text++)
+        {
+            const char c = *text;
+            if(c == '"' || c == '\\')
+                stream << '\\' << c;
+            else if(static_cast<unsigned char>(c) >= 0x20)
+                stream << c;
+        }
+        stream << '"';
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void write_json(std::ostream& stream)
+    {
+        std::scoped_lock lock(registry_mutex);
+
+        const uint64_t epoch = trace_epoch.load(std::memory_order_relaxed);
+
+        // Output follows the Chrome trace event format, which can be
+        // viewed using chrome://tracing or the Perfetto trace viewer.
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool first_event = true;
+        const auto separate = [&](){
+            if(!first_event) stream << ",\n";
+            first_event = false;
+        };
+
+        stream << std::fixed << std::setprecision(3);
+        for(const auto& buffer : thread_buffers)
+        {
+            if(!buffer->thread_name.empty())
+            {
+                separate();
+                stream << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->thread_id
+                       << ",\"args\":{\"name\":";
+                write_json_string(stream, buffer->thread_name.c_str());
+                stream << "}}";
+            }
+
+            const size_t event_count = buffer->size.load(std::memory_order_acquire);
+            for(size_t i = 0; i < event_count; i++)
+            {
+                const auto& event = buffer->events[i];
+                const double timestamp = event.timestamp > epoch ? static_cast<double>(event.timestamp - epoch) : 0.0;
+
+                separate();
+                stream << "{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->thread_id
+                       << ",\"ts\":" << timestamp / 1000.0;
+
+                if(event.phase == 'B')
+                {
+                    stream << ",\"name\":";
+                    write_json_string(stream, event.name);
+                    stream << ",\"cat\":";
+                    write_json_string(stream, event.category);
+                }
+                stream << "}";
+            }
+
+            if(const auto dropped = buffer->dropped.load(std::memory_order_relaxed); dropped > 0)
+            {
+                separate();
+                stream << "{\"ph\":\"M\",\"name\":\"dropped_events\",\"pid\":1,\"tid\":" << buffer->thread_id
+                       << ",\"args\":{\"count\":" << dropped << "}}";
+            }
+        }
+
+        stream << "\n]}\n";
+
+        // The events of exited threads have now been written, so their buffers can be released.
+        prune_exited_buffers();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool dump(const std::filesystem::path& path)
+    {
+        std::ofstream file(path);
+        if(!file.good())
+            return false;
+
+        write_json(file);
+        return file.good();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
+
+namespace lvk
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ScopedTrace::ScopedTrace(const char* name, const char* category)
+        : m_Active(trace::is_enabled())
+    {
+        if(m_Active) trace::begin(name, category);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ScopedTrace::ScopedTrace(const std::string& name, const char* category)
+        : m_Active(trace::is_enabled())
+    {
+        if(m_Active) trace::begin(name, category);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    ScopedTrace::~ScopedTrace()
+    {
+        if(m_Active) trace::end();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
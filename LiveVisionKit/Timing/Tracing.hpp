@@ -0,0 +1,90 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <filesystem>
+
+namespace lvk::trace
+{
+
+    // NOTE: events are recorded into fixed-size buffers owned by each thread,
+    // once a thread's buffer is full, any further events are dropped.
+    void start(const size_t events_per_thread = 1 << 16);
+
+    void stop();
+
+    bool is_enabled();
+
+    void clear();
+
+
+    void name_thread(const std::string& name);
+
+    // NOTE: the category must be a string literal, names are copied.
+    void begin(const char* name, const char* category = "lvk");
+
+    void begin(const std::string& name, const char* category = "lvk");
+
+    void end();
+
+
+    void write_json(std::ostream& stream);
+
+    bool dump(const std::filesystem::path& path);
+
+}
+
+namespace lvk
+{
+
+    class ScopedTrace
+    {
+    public:
+
+        explicit ScopedTrace(const char* name, const char* category = "lvk");
+
+        explicit ScopedTrace(const std::string& name, const char* category = "lvk");
+
+        ~ScopedTrace();
+
+        ScopedTrace(const ScopedTrace&) = delete;
+
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    private:
+        bool m_Active = false;
+    };
+
+}
+
+#define LVK_TRACE_CONCAT_IMPL(a, b) a##b
+#define LVK_TRACE_CONCAT(a, b) LVK_TRACE_CONCAT_IMPL(a, b)
+
+#ifndef LVK_DISABLE_TRACING
+
+#define LVK_TRACE(name) lvk::ScopedTrace LVK_TRACE_CONCAT(_lvk_trace_, __LINE__)(name)
+#define LVK_TRACE_CATEGORY(name, category) lvk::ScopedTrace LVK_TRACE_CONCAT(_lvk_trace_, __LINE__)(name, category)
+
+#else
+
+#define LVK_TRACE(name)
+#define LVK_TRACE_CATEGORY(name, category)
+
+#endif
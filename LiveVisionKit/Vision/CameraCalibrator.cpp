@@ -18,25 +18,96 @@
 #include "CameraCalibrator.hpp"
 
 #include "Directives.hpp"
+#include "Functions/Image.hpp"
 
 namespace lvk
 {
 
+//---------------------------------------------------------------------------------------------------------------------
+
+	static std::optional<std::vector<cv::Point2f>> detect_pattern(
+		const cv::Mat& luma,
+		const cv::Size& pattern_size,
+		const int detection_height
+	)
+	{
+		// Detecting the pattern is much cheaper at a lower resolution, and the
+		// corners only need to be roughly located before they are refined.
+		cv::Mat detection_frame = luma;
+		float detection_scale = 1.0f;
+		if(detection_height > 0 && luma.rows > detection_height)
+		{
+			detection_scale = static_cast<float>(luma.rows) / static_cast<float>(detection_height);
+			cv::resize(luma, detection_frame, cv::Size(), 1.0 / detection_scale, 1.0 / detection_scale, cv::INTER_AREA);
+		}
+
+		std::vector<cv::Point2f> corners;
+		const bool found = cv::findChessboardCorners(
+			detection_frame,
+			pattern_size,
+			corners,
+			cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE | cv::CALIB_CB_FAST_CHECK
+		);
+
+		if(!found)
+			return std::nullopt;
+
+		// Move the corners back to the full resolution frame, and make sure
+		// the refinement window covers the error from the downscaling.
+		for(auto& corner : corners)
+			corner = (corner + cv::Point2f(0.5f, 0.5f)) * detection_scale - cv::Point2f(0.5f, 0.5f);
+
+		const int window_radius = std::max(11, static_cast<int>(std::ceil(2.0f * detection_scale)));
+		cv::cornerSubPix(
+			luma,
+			corners,
+			cv::Size(window_radius, window_radius),
+			cv::Size(-1,-1),
+			cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::MAX_ITER, 30, 0.001)
+		);
+
+		return corners;
+	}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 	CameraCalibrator::CameraCalibrator(const cv::Size& pattern_size)
-		: m_PatternSize(pattern_size),
+		: CameraCalibrator(CameraCalibratorSettings{.pattern_size = pattern_size})
+	{}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	CameraCalibrator::CameraCalibrator(const CameraCalibratorSettings& settings)
+		: m_Settings(settings),
 		  m_DetectionFrame(cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY)
 	{
-		LVK_ASSERT(!pattern_size.empty());
+		LVK_ASSERT(!settings.pattern_size.empty());
+		LVK_ASSERT(settings.detection_height >= 0);
+		LVK_ASSERT(!settings.coverage_grid.empty());
+		LVK_ASSERT(settings.coverage_target > 0);
+		LVK_ASSERT(settings.max_calibration_frames > 0);
+		LVK_ASSERT(settings.frame_stride > 0);
 
 		reset();
 	}
 
 //---------------------------------------------------------------------------------------------------------------------
 
-	bool CameraCalibrator::
-    feed(cv::UMat& frame, const bool draw_corners)
+	CameraCalibrator::~CameraCalibrator()
+	{
+		{
+			std::scoped_lock lock(m_Mutex);
+			m_Terminate = true;
+		}
+		m_QueueFlag.notify_all();
+
+		for(auto& worker : m_Workers)
+			worker.join();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool CameraCalibrator::feed(cv::UMat& frame, const bool draw_corners)
 	{
 		if(m_ImageSize.empty())
 			m_ImageSize = frame.size();
@@ -44,33 +115,169 @@ namespace lvk
 		LVK_ASSERT(frame.size() == m_ImageSize);
 
 		// Extract Y plane for detection.
-		cv::extractChannel(frame, m_DetectionFrame, 0);
+		extract_luma(frame, m_DetectionFrame);
 
-		std::vector<cv::Point2f> corners;
-		const bool found = cv::findChessboardCorners(
-			m_DetectionFrame,
-			m_PatternSize,
-			corners,
-			cv::CALIB_CB_ADAPTIVE_THRESH
+		const auto corners = detect_pattern(
+			m_DetectionFrame.getMat(cv::ACCESS_READ),
+			m_Settings.pattern_size,
+			m_Settings.detection_height
 		);
 
-		if(found)
+		if(corners.has_value())
+		{
+			std::scoped_lock lock(m_Mutex);
+			m_ImagePoints.emplace_back(*corners);
+
+			if(draw_corners)
+				cv::drawChessboardCorners(frame, m_Settings.pattern_size, *corners, true);
+		}
+
+		return corners.has_value();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void CameraCalibrator::submit(const cv::UMat& frame)
+	{
+		if(m_Workers.empty())
+			start_workers();
+
+		if(m_ImageSize.empty())
+			m_ImageSize = frame.size();
+
+		LVK_ASSERT(frame.size() == m_ImageSize);
+
+		// Skip the frame entirely if it's not on the stride, or if no more
+		// patterns can be selected, so that it costs nothing to submit.
+		if(m_SubmittedFrames++ % m_Settings.frame_stride != 0)
+			return;
 		{
-			cv::cornerSubPix(
-				m_DetectionFrame,
-				corners,
-				cv::Size(11,11),
-				cv::Size(-1,-1),
-				cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::MAX_ITER, 30, 0.001)
-			);
-
-			m_ImagePoints.emplace_back(corners);
+			std::scoped_lock lock(m_Mutex);
+			if(is_saturated())
+				return;
 		}
 
-		if(draw_corners)
-			cv::drawChessboardCorners(frame, m_PatternSize, corners, found);
+		// NOTE: the luma is copied to the host, as detection runs on the CPU.
+		extract_luma(frame, m_DetectionFrame);
+		cv::Mat luma = m_DetectionFrame.getMat(cv::ACCESS_READ).clone();
 
-		return found;
+		// Bound the queue to the number of workers, so that the memory used does
+		// not grow if the frames are being submitted faster than we detect them.
+		std::unique_lock lock(m_Mutex);
+		m_QueueFlag.wait(lock, [&](){ return m_FrameQueue.size() < m_Workers.size(); });
+
+		m_FrameQueue.push_back(std::move(luma));
+		m_PendingFrames++;
+
+		lock.unlock();
+		m_QueueFlag.notify_all();
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void CameraCalibrator::wait()
+	{
+		std::unique_lock lock(m_Mutex);
+		m_QueueFlag.wait(lock, [&](){ return m_PendingFrames == 0; });
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void CameraCalibrator::start_workers()
+	{
+		auto thread_count = m_Settings.thread_count;
+		if(thread_count == 0)
+			thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+		for(size_t i = 0; i < thread_count; i++)
+			m_Workers.emplace_back(&CameraCalibrator::run_worker, this);
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	void CameraCalibrator::run_worker()
+	{
+		while(true)
+		{
+			cv::Mat luma;
+			{
+				std::unique_lock lock(m_Mutex);
+				m_QueueFlag.wait(lock, [&](){ return m_Terminate || !m_FrameQueue.empty(); });
+
+				if(m_Terminate)
+					return;
+
+				luma = std::move(m_FrameQueue.front());
+				m_FrameQueue.pop_front();
+			}
+			m_QueueFlag.notify_all();
+
+			const auto corners = detect_pattern(luma, m_Settings.pattern_size, m_Settings.detection_height);
+
+			{
+				std::scoped_lock lock(m_Mutex);
+				if(corners.has_value() && select_pattern(*corners))
+					m_ImagePoints.emplace_back(*corners);
+
+				m_PendingFrames--;
+			}
+			m_QueueFlag.notify_all();
+		}
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool CameraCalibrator::select_pattern(const std::vector<cv::Point2f>& corners)
+	{
+		// NOTE: the mutex must be held by the caller.
+
+		if(m_ImagePoints.size() >= m_Settings.max_calibration_frames)
+			return false;
+
+		// Video tends to contain long runs of near identical patterns, which add little to
+		// the calibration but add to its cost. So a pattern is only kept if it covers part
+		// of the frame which hasn't already been covered by enough patterns.
+		const auto& grid = m_Settings.coverage_grid;
+		const cv::Size2f cell_size(
+			static_cast<float>(m_ImageSize.width) / static_cast<float>(grid.width),
+			static_cast<float>(m_ImageSize.height) / static_cast<float>(grid.height)
+		);
+
+		std::vector<int> cells;
+		for(const auto& corner : corners)
+		{
+			const int x = std::clamp(static_cast<int>(corner.x / cell_size.width), 0, grid.width - 1);
+			const int y = std::clamp(static_cast<int>(corner.y / cell_size.height), 0, grid.height - 1);
+			cells.push_back(y * grid.width + x);
+		}
+		std::sort(cells.begin(), cells.end());
+		cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+		const bool adds_coverage = std::any_of(cells.begin(), cells.end(), [&](const int cell){
+			return m_CoverageCounts[cell] < m_Settings.coverage_target;
+		});
+
+		if(adds_coverage)
+		{
+			for(const auto cell : cells)
+				m_CoverageCounts[cell]++;
+		}
+
+		return adds_coverage;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool CameraCalibrator::is_saturated() const
+	{
+		// NOTE: the mutex must be held by the caller.
+
+		if(m_ImagePoints.size() >= m_Settings.max_calibration_frames)
+			return true;
+
+		return std::all_of(m_CoverageCounts.begin(), m_CoverageCounts.end(), [&](const uint32_t count){
+			return count >= m_Settings.coverage_target;
+		});
 	}
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -80,20 +287,27 @@ namespace lvk
 		LVK_ASSERT(calibration_frames() > 0);
 		LVK_ASSERT(square_size > 0);
 
+		std::vector<std::vector<cv::Point2f>> image_points;
+		{
+			std::scoped_lock lock(m_Mutex);
+			image_points = m_ImagePoints;
+		}
+
+		const auto& pattern_size = m_Settings.pattern_size;
 		std::vector<std::vector<cv::Point3f>> object_points;
-		for(uint32_t i = 0; i < m_ImagePoints.size(); i++)
+		for(uint32_t i = 0; i < image_points.size(); i++)
 		{
 			auto& points = object_points.emplace_back();
 
-			for(int r = 0; r < m_PatternSize.height; r++)
-				for(int c = 0; c < m_PatternSize.width; c++)
+			for(int r = 0; r < pattern_size.height; r++)
+				for(int c = 0; c < pattern_size.width; c++)
 					points.emplace_back(c * square_size, r * square_size, 0);
 		}
 
 		CameraParameters parameters;
 		cv::calibrateCamera(
 			object_points,
-			m_ImagePoints,
+			image_points,
 			m_ImageSize,
 			parameters.camera_matrix,
 			parameters.distortion_coefficients,
@@ -104,12 +318,27 @@ namespace lvk
 		return parameters;
 	}
 
+//---------------------------------------------------------------------------------------------------------------------
+
+	std::future<CameraParameters> CameraCalibrator::calibrate_async(const uint32_t square_size)
+	{
+		return std::async(std::launch::async, [this, square_size](){
+			wait();
+			return calibrate(square_size);
+		});
+	}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 	void CameraCalibrator::reset()
 	{
+		wait();
+
+		std::scoped_lock lock(m_Mutex);
 		m_ImageSize = cv::Size(0, 0);
 		m_ImagePoints.clear();
+		m_CoverageCounts.assign(m_Settings.coverage_grid.area(), 0);
+		m_SubmittedFrames = 0;
 
 		m_DetectionFrame.release();
 	}
@@ -118,9 +347,49 @@ namespace lvk
 
 	uint32_t CameraCalibrator::calibration_frames() const
 	{
+		std::scoped_lock lock(m_Mutex);
 		return m_ImagePoints.size();
 	}
 
+//---------------------------------------------------------------------------------------------------------------------
+
+	bool save_camera_parameters(const CameraParameters& parameters, const std::string& path)
+	{
+		LVK_ASSERT(parameters.camera_matrix.type() == CV_64FC1);
+		LVK_ASSERT(parameters.camera_matrix.size() == cv::Size(3,3));
+		LVK_ASSERT(!path.empty());
+
+		cv::FileStorage file(path, cv::FileStorage::WRITE);
+		if(!file.isOpened())
+			return false;
+
+		file << "camera_matrix" << parameters.camera_matrix;
+		file << "distortion_coefficients" << parameters.distortion_coefficients;
+
+		return true;
+	}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+	std::optional<CameraParameters> load_camera_parameters(const std::string& path)
+	{
+		LVK_ASSERT(!path.empty());
+
+		cv::FileStorage file(path, cv::FileStorage::READ);
+		if(!file.isOpened())
+			return std::nullopt;
+
+		CameraParameters parameters;
+		file["camera_matrix"] >> parameters.camera_matrix;
+		file["distortion_coefficients"] >> parameters.distortion_coefficients;
+
+		if(parameters.camera_matrix.size() != cv::Size(3,3) || parameters.distortion_coefficients.empty())
+			return std::nullopt;
+
+		parameters.camera_matrix.convertTo(parameters.camera_matrix, CV_64FC1);
+		return parameters;
+	}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 }
@@ -17,6 +17,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <algorithm>
+#include <optional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <deque>
 #include <opencv2/opencv.hpp>
 
 namespace lvk
@@ -28,29 +35,83 @@ namespace lvk
 		std::vector<double> distortion_coefficients;
 	};
 
+	struct CameraCalibratorSettings
+	{
+		cv::Size pattern_size = {9, 6};
+
+		// Patterns are detected on frames downscaled to at most this height,
+		// then the corners are refined at full resolution. Zero disables this.
+		int detection_height = 720;
+
+		// NOTE: zero uses all the available hardware threads.
+		size_t thread_count = 0;
+
+		// Submitted patterns are only kept if they cover a cell of the coverage
+		// grid which has been covered by fewer patterns than the target.
+		cv::Size coverage_grid = {6, 4};
+		uint32_t coverage_target = 3;
+		uint32_t max_calibration_frames = 40;
+
+		// Only every n-th submitted frame is searched for a pattern.
+		uint32_t frame_stride = 1;
+	};
+
 	class CameraCalibrator
 	{
 	public:
 
-        explicit CameraCalibrator(const cv::Size& pattern_size) ;
+        explicit CameraCalibrator(const cv::Size& pattern_size);
+
+        explicit CameraCalibrator(const CameraCalibratorSettings& settings);
+
+        ~CameraCalibrator();
 
 		// Expects YUV frame
 		bool feed(cv::UMat& frame, const bool draw_corners = false);
 
+		// Expects YUV frame, the pattern is detected in the background.
+		void submit(const cv::UMat& frame);
+
+		// Waits for all the submitted frames to be processed.
+		void wait();
+
 		CameraParameters calibrate(const uint32_t square_size = 1) const;
 
+		std::future<CameraParameters> calibrate_async(const uint32_t square_size = 1);
+
         uint32_t calibration_frames() const;
 
         void reset();
 
 	private:
 
-		const cv::Size m_PatternSize;
+		void start_workers();
+
+		void run_worker();
+
+		bool select_pattern(const std::vector<cv::Point2f>& corners);
+
+		bool is_saturated() const;
+
+	private:
+		const CameraCalibratorSettings m_Settings;
 
 		cv::Size m_ImageSize;
 		cv::UMat m_DetectionFrame;
 		std::vector<std::vector<cv::Point2f>> m_ImagePoints;
+		std::vector<uint32_t> m_CoverageCounts;
 
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_QueueFlag;
+		std::deque<cv::Mat> m_FrameQueue;
+		std::vector<std::thread> m_Workers;
+		size_t m_PendingFrames = 0, m_SubmittedFrames = 0;
+		bool m_Terminate = false;
 	};
 
+	// NOTE: the file format is chosen by cv::FileStorage from the path's extension.
+	bool save_camera_parameters(const CameraParameters& parameters, const std::string& path);
+
+	std::optional<CameraParameters> load_camera_parameters(const std::string& path);
+
 }
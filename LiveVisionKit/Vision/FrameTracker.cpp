@@ -22,6 +22,7 @@
 #include "Functions/Math.hpp"
 #include "Functions/Container.hpp"
 #include "Functions/Extensions.hpp"
+#include "Timing/Tracing.hpp"
 
 namespace lvk
 {
@@ -60,10 +61,16 @@ namespace lvk
         m_InlierStatus.reserve(m_FeatureDetector.feature_capacity());
         m_MatchStatus.reserve(m_FeatureDetector.feature_capacity());
 
+        // The rolling shutter model describes each band of rows with its own
+        // motion, so it only needs the motion resolution's columns.
+        m_MotionResolution = settings.motion_resolution;
+        if(settings.rolling_shutter_bands > 0)
+            m_MotionResolution.height = static_cast<int>(settings.rolling_shutter_bands) + 1;
+
         // If we are tracking motion with a resolution of 2x2 (Homography)
         // then tighten up the homography estimation parameters for global
         // motion. Otherwise, loosen them up to allow local motion through.
-        if(settings.motion_resolution == WarpField::MinimumSize)
+        if(m_MotionResolution == WarpField::MinimumSize && settings.rolling_shutter_bands == 0)
         {
             // For accurate Homography estimation
             m_USACParams.sampler = cv::SAMPLING_UNIFORM;
@@ -106,6 +113,8 @@ namespace lvk
 
     std::optional<WarpField> FrameTracker::track(const cv::UMat& next_frame)
 	{
+        LVK_TRACE("FrameTracker::track");
+
 		LVK_ASSERT(!next_frame.empty());
 		LVK_ASSERT(next_frame.type() == CV_8UC1);
 
@@ -183,13 +192,14 @@ namespace lvk
 
 
         // Convert the global Homography into a motion field.
-        WarpField motion_field(m_Settings.motion_resolution);
-        if(m_Settings.motion_resolution != WarpField::MinimumSize)
-        {
-            const cv::Rect2f region({0,0}, tracking_resolution());
+        WarpField motion_field(m_MotionResolution);
+        const cv::Rect2f region({0,0}, tracking_resolution());
+        if(m_Settings.rolling_shutter_bands > 0)
+            motion_field.fit_rows(region, m_TrackedPoints, m_MatchedPoints, *motion);
+        else if(m_MotionResolution != WarpField::MinimumSize)
             motion_field.fit_points(region, m_TrackedPoints, m_MatchedPoints, motion);
-        }
-        else motion_field.set_to(*motion, tracking_resolution());
+        else
+            motion_field.set_to(*motion, tracking_resolution());
 
 
         // We must scale the motion to match the original frame size.
@@ -226,7 +236,7 @@ namespace lvk
 
     const cv::Size& FrameTracker::motion_resolution() const
     {
-        return m_Settings.motion_resolution;
+        return m_MotionResolution;
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -30,6 +30,10 @@ namespace lvk
     {
         cv::Size motion_resolution = {2, 2};
 
+        // Number of row bands in the rolling shutter motion model, which replaces the
+        // rows of the motion resolution when enabled. Zero disables the model.
+        uint32_t rolling_shutter_bands = 0;
+
         // Motion Estimation Constraints
         float stability_threshold = 0.3f;
         float uniformity_threshold = 0.1f;
@@ -66,6 +70,7 @@ namespace lvk
         GridDetector m_FeatureDetector;
 		std::vector<cv::Point2f> m_TrackedPoints, m_MatchedPoints;
 
+		cv::Size m_MotionResolution = WarpField::MinimumSize;
 		cv::UsacParams m_USACParams;
 		std::vector<uint8_t> m_MatchStatus, m_InlierStatus;
 		float m_Stability = 0.0f, m_Uniformity = 0.0f;
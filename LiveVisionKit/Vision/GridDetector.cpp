@@ -19,6 +19,7 @@
 
 #include "Directives.hpp"
 #include "Functions/Math.hpp"
+#include "Timing/Tracing.hpp"
 
 namespace lvk
 {
@@ -114,6 +115,8 @@ namespace lvk
 
 	void GridDetector::detect(cv::UMat& frame, std::vector<cv::Point2f>& points)
 	{
+        LVK_TRACE("GridDetector::detect");
+
 		LVK_ASSERT(frame.size() == input_resolution());
 		LVK_ASSERT(frame.type() == CV_8UC1);
 
@@ -19,6 +19,7 @@
 
 #include "Functions/Math.hpp"
 #include "Logging/CSVLogger.hpp"
+#include "Timing/Tracing.hpp"
 
 namespace lvk
 {
@@ -46,6 +47,14 @@ namespace lvk
         LVK_ASSERT_01_STRICT(settings.scene_margins);
 
         m_Settings = settings;
+
+        // Changing the storage discards all the delayed frames.
+        if(settings.frame_storage != m_FrameQueue.storage())
+        {
+            m_FrameQueue.set_storage(settings.frame_storage);
+            restart();
+        }
+
         configure_buffers();
     }
 
@@ -60,6 +69,8 @@ namespace lvk
 
     Frame PathStabilizer::next(Frame&& frame, const WarpField& motion)
     {
+        LVK_TRACE("PathStabilizer::next");
+
         LVK_ASSERT(!frame.is_empty());
 
         // Resize past motions if a new size is given.
@@ -124,6 +135,19 @@ namespace lvk
             if(m_Settings.crop_frame_to_margins)
                 path_correction.crop_in(m_Margins, curr_frame.size());
 
+            // Track the motion between consecutive output frames so that other filters can
+            // re-use it without tracking the stabilized frames again. The corrected frame
+            // lands on the path position plus its correction, whose difference from the last
+            // output position approximates the motion between the two output frames.
+            auto output_position = curr_position + path_correction;
+            if(m_HasOutput)
+                m_OutputMotion = output_position - m_OutputPosition;
+            else
+                m_OutputMotion = WarpField(output_position.size());
+
+            m_OutputPosition = std::move(output_position);
+            m_HasOutput = true;
+
             // NOTE: we perform a swap between the resulting warp frame
             // and the original frame data to ensure zero de-allocations.
             path_correction.apply(curr_frame.data, m_WarpFrame, true);
@@ -142,6 +166,9 @@ namespace lvk
         m_FrameQueue.clear();
         m_Path.clear();
 
+        m_HasOutput = false;
+        m_OutputMotion.set_identity();
+
         // Pre-fill the trace to avoid having to deal with edge cases.
         while(!m_Path.is_full()) m_Path.advance(WarpField::MinimumSize);
     }
@@ -176,6 +203,13 @@ namespace lvk
         return m_Margins;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    const WarpField& PathStabilizer::output_motion() const
+    {
+        return m_OutputMotion;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void PathStabilizer::configure_buffers()
@@ -220,6 +254,7 @@ namespace lvk
     void PathStabilizer::resize_fields(const cv::Size& new_size)
     {
         m_Trace.resize(new_size);
+        m_OutputPosition.resize(new_size);
         for(auto& position : m_Path)
         {
             position.resize(new_size);
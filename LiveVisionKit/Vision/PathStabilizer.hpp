@@ -23,6 +23,7 @@
 #include "Filters/VideoFrame.hpp"
 #include "Utility/Configurable.hpp"
 #include "Structures/StreamBuffer.hpp"
+#include "Structures/FrameSpool.hpp"
 
 namespace lvk
 {
@@ -38,6 +39,10 @@ namespace lvk
 
         float rigidity_tolerance = 0.2f;
         bool force_output_rigidity = true;
+
+        // NOTE: spilling the delayed frames off the device bounds the
+        // device memory used by the stabilizer, regardless of the delay.
+        FrameStorage frame_storage = FrameStorage::DEVICE;
     };
 
     class PathStabilizer final : public Configurable<PathStabilizerSettings>
@@ -62,6 +67,9 @@ namespace lvk
 
         const cv::Rect& stable_region() const;
 
+        // Motion between the last two output frames, after stabilization.
+        const WarpField& output_motion() const;
+
     private:
 
         void configure_buffers();
@@ -73,8 +81,12 @@ namespace lvk
         StreamBuffer<WarpField> m_Path;
         WarpField m_Trace{WarpField::MinimumSize};
 
+        bool m_HasOutput = false;
+        WarpField m_OutputPosition{WarpField::MinimumSize};
+        WarpField m_OutputMotion{WarpField::MinimumSize};
+
         cv::Rect m_Margins{0,0,0,0};
-        StreamBuffer<Frame> m_FrameQueue;
+        FrameSpool m_FrameQueue;
         cv::UMat m_WarpFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
     };
 
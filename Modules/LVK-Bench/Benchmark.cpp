@@ -0,0 +1,171 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace bench
+{
+//---------------------------------------------------------------------------------------------------------------------
+
+    constexpr size_t MIN_SAMPLES = 5;
+    constexpr size_t MAX_SAMPLES = 10000;
+    constexpr size_t MAX_BATCH_SIZE = 1 << 20;
+    const lvk::Time MIN_BATCH_TIME = lvk::Time::Microseconds(500);
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    BenchmarkSuite::BenchmarkSuite(std::string name, const lvk::Time& sample_time, std::string filter)
+        : m_Name(std::move(name)),
+          m_Filter(std::move(filter)),
+          m_SampleTime(sample_time)
+    {}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void BenchmarkSuite::run(
+        const std::string& name,
+        const std::string& parameters,
+        const std::function<void()>& operation
+    )
+    {
+        if(!m_Filter.empty() && name.find(m_Filter) == std::string::npos)
+            return;
+
+        lvk::Stopwatch timer;
+
+        // Warm up to get any allocations and OpenCL compilations out of the way.
+        operation();
+
+        // Batch up fast operations so that each sample is well above the timer resolution.
+        size_t batch_size = 1;
+        while(batch_size < MAX_BATCH_SIZE)
+        {
+            timer.start();
+            for(size_t i = 0; i < batch_size; i++)
+                operation();
+
+            if(timer.stop() >= MIN_BATCH_TIME)
+                break;
+
+            batch_size *= 2;
+        }
+
+        std::vector<lvk::Time> samples;
+        lvk::Time total_time(0);
+        while(samples.size() < MAX_SAMPLES && (samples.size() < MIN_SAMPLES || total_time < m_SampleTime))
+        {
+            timer.start();
+            for(size_t i = 0; i < batch_size; i++)
+                operation();
+            const auto batch_time = timer.stop();
+
+            samples.push_back(batch_time / static_cast<double>(batch_size));
+            total_time += batch_time;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        auto& result = m_Results.emplace_back();
+        result.name = name;
+        result.parameters = parameters;
+        result.samples = samples.size();
+        result.iterations = samples.size() * batch_size;
+        result.min = samples.front();
+        result.max = samples.back();
+        result.median = samples[samples.size() / 2];
+        result.p90 = samples[std::min(samples.size() - 1, (samples.size() * 9) / 10)];
+        result.mean = lvk::mean(samples.begin(), samples.end());
+
+        // Progress goes to the error stream, leaving the output stream for the JSON.
+        std::cerr << std::left << std::setw(32) << name
+                  << std::setw(24) << parameters
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << result.median.microseconds() << "us"
+                  << "  (p90 " << result.p90.microseconds() << "us)\n";
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const std::vector<BenchmarkResult>& BenchmarkSuite::results() const
+    {
+        return m_Results;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void BenchmarkSuite::write_json(std::ostream& stream) const
+    {
+        const auto& device = cv::ocl::Device::getDefault();
+        const std::string opencl_device = cv::ocl::useOpenCL() ? device.name() : "none";
+
+        stream << "{\n";
+        stream << "  \"suite\": \"" << json_escape(m_Name) << "\",\n";
+        stream << "  \"timestamp\": \"" << json_escape(lvk::Time::Timestamp()) << "\",\n";
+        stream << "  \"opencv_version\": \"" << CV_VERSION << "\",\n";
+        stream << "  \"opencl_device\": \"" << json_escape(opencl_device) << "\",\n";
+        stream << "  \"benchmarks\": [\n";
+
+        stream << std::fixed << std::setprecision(1);
+        for(size_t i = 0; i < m_Results.size(); i++)
+        {
+            const auto& result = m_Results[i];
+            stream << "    {"
+                   << "\"name\": \"" << json_escape(result.name) << "\", "
+                   << "\"parameters\": \"" << json_escape(result.parameters) << "\", "
+                   << "\"samples\": " << result.samples << ", "
+                   << "\"iterations\": " << result.iterations << ", "
+                   << "\"min_ns\": " << result.min.nanoseconds() << ", "
+                   << "\"median_ns\": " << result.median.nanoseconds() << ", "
+                   << "\"mean_ns\": " << result.mean.nanoseconds() << ", "
+                   << "\"p90_ns\": " << result.p90.nanoseconds() << ", "
+                   << "\"max_ns\": " << result.max.nanoseconds()
+                   << "}" << (i + 1 < m_Results.size() ? ",\n" : "\n");
+        }
+
+        stream << "  ]\n";
+        stream << "}\n";
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::string json_escape(const std::string& text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+
+        for(const char c : text)
+        {
+            switch(c)
+            {
+                case '"':  escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if(static_cast<unsigned char>(c) >= 0x20)
+                        escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
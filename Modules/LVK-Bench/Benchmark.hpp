@@ -0,0 +1,71 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <LiveVisionKit.hpp>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string parameters;
+
+        size_t samples = 0;
+        size_t iterations = 0;
+
+        // Per-iteration timings
+        lvk::Time min, median, mean, p90, max;
+    };
+
+
+    class BenchmarkSuite
+    {
+    public:
+
+        BenchmarkSuite(std::string name, const lvk::Time& sample_time, std::string filter = "");
+
+        void run(const std::string& name, const std::string& parameters, const std::function<void()>& operation);
+
+        const std::vector<BenchmarkResult>& results() const;
+
+        void write_json(std::ostream& stream) const;
+
+    private:
+        std::string m_Name, m_Filter;
+        lvk::Time m_SampleTime;
+        std::vector<BenchmarkResult> m_Results;
+    };
+
+
+    // Stops the compiler from optimizing away the computation of the value.
+    template<typename T>
+    inline void keep_alive(const T& value)
+    {
+        static thread_local const volatile void* sink = nullptr;
+        sink = static_cast<const void*>(&value);
+    }
+
+    std::string json_escape(const std::string& text);
+
+}
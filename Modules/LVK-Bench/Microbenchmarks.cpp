@@ -0,0 +1,395 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include <LiveVisionKit.hpp>
+#include <iostream>
+#include <fstream>
+
+#include "Benchmark.hpp"
+
+using namespace lvk;
+using namespace bench;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+constexpr uint64_t RANDOM_SEED = 0x4C564B;
+
+const std::vector<std::pair<std::string, cv::Size>> FRAME_SIZES = {
+    {"720p", {1280, 720}},
+    {"1080p", {1920, 1080}},
+    {"4K", {3840, 2160}}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static std::vector<cv::Point2f> random_points(const size_t count, const cv::Rect2f& region, cv::RNG& rng)
+{
+    std::vector<cv::Point2f> points(count);
+    for(auto& point : points)
+    {
+        point.x = rng.uniform(region.x, region.x + region.width);
+        point.y = rng.uniform(region.y, region.y + region.height);
+    }
+    return points;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static cv::Mat textured_frame(const cv::Size& size, cv::RNG& rng)
+{
+    // Blurred noise gives plenty of corners for detection without being degenerate.
+    cv::Mat frame(size, CV_8UC1);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(frame, frame, cv::Size(5, 5), 1.5);
+    return frame;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static WarpField random_field(const cv::Size& size, cv::RNG& rng)
+{
+    cv::Mat offsets(size, CV_32FC2);
+    rng.fill(offsets, cv::RNG::UNIFORM, -10.0f, 10.0f);
+    return WarpField(std::move(offsets), true);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void run_structure_benchmarks(BenchmarkSuite& suite)
+{
+    cv::RNG rng(RANDOM_SEED);
+
+    for(const size_t capacity : {32, 256, 4096})
+    {
+        const auto parameters = cv::format("capacity=%zu", capacity);
+
+        StreamBuffer<float> buffer(capacity);
+        suite.run("StreamBuffer::push", parameters, [&](){
+            buffer.push(1.0f);
+        });
+
+        StreamBuffer<float> kernel(std::min<size_t>(capacity, 31));
+        while(!kernel.is_full()) kernel.push(1.0f / static_cast<float>(kernel.capacity()));
+        while(!buffer.is_full()) buffer.push(rng.uniform(0.0f, 1.0f));
+
+        suite.run("StreamBuffer::convolve", parameters, [&](){
+            auto result = buffer.convolve(kernel);
+            keep_alive(result);
+        });
+    }
+
+    for(const cv::Size resolution : {cv::Size(32, 18), cv::Size(128, 72)})
+    {
+        const auto parameters = cv::format("resolution=%dx%d", resolution.width, resolution.height);
+        const cv::Rect2f region(0, 0, 1920, 1080);
+
+        SpatialMap<cv::Point2f> map(resolution, region);
+        const auto points = random_points(map.capacity(), region, rng);
+
+        suite.run("SpatialMap::place", parameters, [&](){
+            map.clear();
+            for(const auto& point : points)
+                map.place(point, point);
+        });
+
+        suite.run("SpatialMap::clear", parameters, [&](){
+            for(const auto& point : points)
+                map.try_place(point, point);
+            map.clear();
+        });
+
+        for(const auto& point : points)
+            map.try_place(point, point);
+
+        suite.run("SpatialMap::iterate", parameters, [&](){
+            cv::Point2f total(0, 0);
+            for(const auto& [key, point] : map)
+                total += point;
+            keep_alive(total);
+        });
+
+        VirtualGrid grid(resolution, region);
+        const auto query_points = random_points(10000, cv::Rect2f(-100, -100, 2120, 1280), rng);
+
+        suite.run("VirtualGrid::try_key_of", parameters + " points=10000", [&](){
+            size_t hits = 0;
+            for(const auto& point : query_points)
+                hits += grid.try_key_of(point).has_value();
+            keep_alive(hits);
+        });
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void run_math_benchmarks(BenchmarkSuite& suite)
+{
+    cv::RNG rng(RANDOM_SEED);
+
+    for(const cv::Size field_size : {cv::Size(16, 16), cv::Size(64, 64)})
+    {
+        const auto parameters = cv::format("field=%dx%d", field_size.width, field_size.height);
+
+        const auto field_a = random_field(field_size, rng), field_b = random_field(field_size, rng);
+        WarpField field = field_a;
+
+        suite.run("WarpField::operator+=", parameters, [&](){
+            field += field_b;
+        });
+
+        suite.run("WarpField::combine", parameters, [&](){
+            field.combine(field_b, 0.5f);
+        });
+
+        suite.run("WarpField::blend", parameters, [&](){
+            field.blend(0.9f, field_a);
+        });
+
+        suite.run("WarpField::undistort", parameters, [&](){
+            field = field_a;
+            field.undistort();
+        });
+
+        const cv::Rect2f region(0, 0, 1920, 1080);
+        const auto motion = Homography::FromAffineMatrix(
+            cv::getRotationMatrix2D(cv::Point2f(960, 540), 1.5, 1.01)
+        );
+
+        for(const size_t point_count : {250, 1000})
+        {
+            const auto origin_points = random_points(point_count, region, rng);
+            const auto warped_points = motion * origin_points;
+
+            suite.run("WarpField::fit_points", parameters + cv::format(" points=%zu", point_count), [&](){
+                field.fit_points(region, origin_points, warped_points, motion);
+            });
+        }
+    }
+
+    for(const auto& [name, frame_size] : FRAME_SIZES)
+    {
+        const auto parameters = "frame=" + name;
+
+        cv::UMat src, dst;
+        cv::Mat frame(frame_size, CV_8UC3);
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        frame.copyTo(src);
+
+        const auto field = random_field(cv::Size(16, 16), rng);
+        suite.run("WarpField::apply", parameters, [&](){
+            field.apply(src, dst);
+            cv::ocl::finish();
+        });
+
+        cv::UMat intermediate;
+        const auto second_field = random_field(cv::Size(16, 16), rng);
+        suite.run("WarpField::apply (sequential)", parameters, [&](){
+            field.apply(src, intermediate);
+            second_field.apply(intermediate, dst);
+            cv::ocl::finish();
+        });
+
+        const cv::Size2f field_scale = frame_size;
+        suite.run("WarpField::compose+apply", parameters, [&](){
+            const auto composed = compose(field, second_field, field_scale);
+            composed.apply(src, dst);
+            cv::ocl::finish();
+        });
+    }
+
+    cv::UsacParams usac_params;
+    usac_params.sampler = cv::SAMPLING_UNIFORM;
+    usac_params.score = cv::SCORE_METHOD_MSAC;
+    usac_params.loMethod = cv::LOCAL_OPTIM_INNER_LO;
+    usac_params.maxIterations = 100;
+    usac_params.confidence = 0.99;
+    usac_params.loIterations = 10;
+    usac_params.loSampleSize = 20;
+    usac_params.threshold = 20;
+
+    for(const size_t point_count : {250, 1000})
+    {
+        const cv::Rect2f region(0, 0, 640, 360);
+        const auto motion = Homography::FromAffineMatrix(
+            cv::getRotationMatrix2D(cv::Point2f(320, 180), 2.0, 1.0)
+        );
+
+        // Add some noise and 20% outliers to the matched points.
+        const auto tracked_points = random_points(point_count, region, rng);
+        auto matched_points = motion * tracked_points;
+        for(size_t i = 0; i < matched_points.size(); i++)
+        {
+            if(i % 5 == 0)
+                matched_points[i] = random_points(1, region, rng).front();
+            else
+                matched_points[i] += cv::Point2f(rng.gaussian(0.5), rng.gaussian(0.5));
+        }
+
+        std::vector<uint8_t> inlier_status;
+        suite.run("Homography::Estimate", cv::format("points=%zu", point_count), [&](){
+            auto estimate = Homography::Estimate(tracked_points, matched_points, inlier_status, usac_params);
+            keep_alive(estimate);
+        });
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void run_vision_benchmarks(BenchmarkSuite& suite)
+{
+    cv::RNG rng(RANDOM_SEED);
+
+    for(const cv::Size detect_resolution : {cv::Size(640, 360), cv::Size(1280, 720)})
+    {
+        const auto parameters = cv::format("resolution=%dx%d", detect_resolution.width, detect_resolution.height);
+
+        GridDetectorSettings settings;
+        settings.detect_resolution = detect_resolution;
+        GridDetector detector(settings);
+
+        cv::UMat frame;
+        textured_frame(detect_resolution, rng).copyTo(frame);
+
+        std::vector<cv::Point2f> points;
+        suite.run("GridDetector::detect", parameters, [&](){
+            // Reset so every iteration performs a full detection.
+            detector.reset();
+            points.clear();
+            detector.detect(frame, points);
+        });
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static bool check_warp_composition()
+{
+    cv::RNG rng(RANDOM_SEED);
+
+    // The composed field must produce the same output as applying both fields in
+    // sequence, up to the interpolation error of the resampling which it removes.
+    // Smooth frames are used so that this error stays small, and the borders are
+    // ignored as the sequential path loses more of them to the constant border.
+    constexpr double tolerance = 3.0;
+    constexpr int border_margin = 24;
+
+    bool passed = true;
+    for(const auto& [name, frame_size] : FRAME_SIZES)
+    {
+        cv::Mat frame(frame_size, CV_8UC3);
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(frame, frame, cv::Size(0, 0), 4.0);
+
+        cv::UMat src, intermediate, sequential, composed;
+        frame.copyTo(src);
+
+        const auto first = random_field(cv::Size(16, 16), rng);
+        const auto second = random_field(cv::Size(16, 16), rng);
+
+        first.apply(src, intermediate);
+        second.apply(intermediate, sequential);
+        compose(first, second, frame_size).apply(src, composed);
+
+        const cv::Rect interior(
+            border_margin, border_margin,
+            frame_size.width - 2 * border_margin, frame_size.height - 2 * border_margin
+        );
+
+        cv::Mat difference;
+        cv::absdiff(sequential(interior), composed(interior), difference);
+        const cv::Scalar channel_error = cv::mean(difference);
+        const double error = std::max({channel_error[0], channel_error[1], channel_error[2]});
+
+        if(error > tolerance)
+        {
+            std::cerr << cv::format(
+                "WarpField::compose check failed for %s, mean error of %.3f exceeds %.3f\n",
+                name.c_str(), error, tolerance
+            );
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void print_usage()
+{
+    std::cerr << "Usage: lvk-bench [-f filter] [-t seconds] [-o output.json]\n\n"
+              << "  -f  Only run benchmarks whose name contains the filter\n"
+              << "  -t  Minimum sampling time per benchmark in seconds (default 0.5)\n"
+              << "  -o  Write the JSON results to a file instead of the standard output\n";
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string filter, output_path;
+    double sample_time = 0.5;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string option = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if(option == "-f" && has_value)
+            filter = argv[++i];
+        else if(option == "-t" && has_value)
+            sample_time = std::max(0.0, std::atof(argv[++i]));
+        else if(option == "-o" && has_value)
+            output_path = argv[++i];
+        else
+        {
+            print_usage();
+            return option == "-h" ? 0 : 1;
+        }
+    }
+
+    lvk::context::assert_handler = [](auto, auto, const std::string& assertion){
+        std::cerr << cv::format("LiveVisionKit failed condition: %s\n", assertion.c_str());
+        std::abort();
+    };
+
+    // Composition is only an optimization if it matches the sequential output.
+    if(!check_warp_composition())
+        return 1;
+
+    BenchmarkSuite suite("lvk-bench", Time::Seconds(sample_time), filter);
+    run_structure_benchmarks(suite);
+    run_math_benchmarks(suite);
+    run_vision_benchmarks(suite);
+
+    if(output_path.empty())
+    {
+        suite.write_json(std::cout);
+        return 0;
+    }
+
+    std::ofstream output_file(output_path);
+    if(!output_file.good())
+    {
+        std::cerr << "Failed to open output file \'" << output_path << "\'\n";
+        return 1;
+    }
+    suite.write_json(output_file);
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
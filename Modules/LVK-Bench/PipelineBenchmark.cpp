@@ -0,0 +1,437 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include <LiveVisionKit.hpp>
+#include <Filters/ScalingFilter.hpp>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "Benchmark.hpp"
+
+using namespace lvk;
+using namespace bench;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+constexpr uint64_t RANDOM_SEED = 0x4C564B;
+constexpr size_t WARMUP_FRAMES = 10;
+constexpr double FRAME_RATE = 60.0;
+
+// Ground truth camera motion, relative to the frame width.
+constexpr double PAN_SPEED = 0.001;
+constexpr double JITTER_AMPLITUDE = 0.004;
+constexpr double ROTATION_JITTER = 0.3;
+
+// Resolution at which the output motion is measured.
+constexpr int MEASURE_WIDTH = 640;
+
+const std::vector<std::pair<std::string, cv::Size>> FRAME_SIZES = {
+    {"720p", {1280, 720}},
+    {"1080p", {1920, 1080}},
+    {"4K", {3840, 2160}}
+};
+
+const std::vector<std::string> FILTER_CHAINS = {
+    "stabilization",
+    "deblocking",
+    "scaling",
+    "full"
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+struct PipelineResult
+{
+    std::string chain, resolution;
+    size_t frames = 0;
+
+    double fps = 0.0;
+    Time p50_latency, p99_latency, max_latency;
+
+    // NOTE: this is the peak resident memory above what the process held before the
+    // pipeline was created, it does not include any memory allocated on the GPU.
+    double peak_memory_mb = 0.0;
+
+    double input_jitter = 0.0;
+    double residual_jitter = 0.0;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+class SyntheticVideo
+{
+public:
+
+    SyntheticVideo(const cv::Size& size, const uint64_t seed)
+        : m_Size(size),
+          m_RNG(seed)
+    {
+        // Build a textured scene with features at many scales so that both
+        // the tracker and the phase correlation have something to lock onto.
+        cv::Mat scene(size, CV_8UC3), detail(size, CV_8UC3);
+        m_RNG.fill(scene, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(scene, scene, cv::Size(0, 0), static_cast<double>(size.width) / 200.0);
+        cv::normalize(scene, scene, 0, 255, cv::NORM_MINMAX);
+
+        m_RNG.fill(detail, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(detail, detail, cv::Size(5, 5), 1.0);
+        cv::addWeighted(scene, 0.7, detail, 0.3, 0.0, scene);
+
+        const int shape_count = size.area() / 20000;
+        for(int i = 0; i < shape_count; i++)
+        {
+            const cv::Point centre(m_RNG.uniform(0, size.width), m_RNG.uniform(0, size.height));
+            const cv::Scalar colour(m_RNG.uniform(0, 256), m_RNG.uniform(0, 256), m_RNG.uniform(0, 256));
+            const int radius = m_RNG.uniform(size.width / 200 + 1, size.width / 40 + 2);
+
+            if(i % 2 == 0)
+                cv::circle(scene, centre, radius, colour, cv::FILLED);
+            else
+                cv::rectangle(scene, cv::Rect(centre, cv::Size(radius, radius)), colour, cv::FILLED);
+        }
+
+        cv::cvtColor(scene, m_Scene, cv::COLOR_BGR2YUV);
+    }
+
+    Frame next()
+    {
+        // The camera pans smoothly and is shaken by random jitter on top.
+        const auto width = static_cast<double>(m_Size.width);
+        const cv::Point2d pan(PAN_SPEED * width * static_cast<double>(m_Index), 0.0);
+        const cv::Point2d jitter(
+            m_RNG.gaussian(JITTER_AMPLITUDE * width),
+            m_RNG.gaussian(JITTER_AMPLITUDE * width)
+        );
+        const double angle = m_RNG.gaussian(ROTATION_JITTER);
+
+        cv::Mat transform = cv::getRotationMatrix2D(
+            cv::Point2f(static_cast<float>(m_Size.width) / 2.0f, static_cast<float>(m_Size.height) / 2.0f),
+            angle,
+            1.0
+        );
+        transform.at<double>(0, 2) -= pan.x + jitter.x;
+        transform.at<double>(1, 2) -= pan.y + jitter.y;
+
+        Frame frame(static_cast<uint64_t>(m_Index));
+        cv::warpAffine(m_Scene, m_WarpBuffer, transform, m_Size, cv::INTER_LINEAR, cv::BORDER_REFLECT);
+        m_WarpBuffer.copyTo(frame.data);
+
+        m_Jitter.push_back(jitter);
+        m_Index++;
+
+        return frame;
+    }
+
+    // Ground truth content shift between two frames, excluding the jitter.
+    cv::Point2d smooth_shift(const size_t from, const size_t to) const
+    {
+        const double frames = static_cast<double>(to) - static_cast<double>(from);
+        return {-PAN_SPEED * static_cast<double>(m_Size.width) * frames, 0.0};
+    }
+
+    // Root mean squared inter-frame jitter of the generated frames.
+    double jitter_rms() const
+    {
+        double total = 0.0;
+        for(size_t i = 1; i < m_Jitter.size(); i++)
+        {
+            const auto delta = m_Jitter[i] - m_Jitter[i - 1];
+            total += delta.dot(delta);
+        }
+        return m_Jitter.size() > 1 ? std::sqrt(total / static_cast<double>(m_Jitter.size() - 1)) : 0.0;
+    }
+
+private:
+    cv::Size m_Size;
+    cv::RNG m_RNG;
+    size_t m_Index = 0;
+
+    cv::Mat m_Scene, m_WarpBuffer;
+    std::vector<cv::Point2d> m_Jitter;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static double resident_memory_mb()
+{
+    // NOTE: the process peak (ru_maxrss) only ever grows, so it can't be attributed
+    // to a single pipeline. Instead, the current resident set size is sampled.
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if(!(statm >> total_pages >> resident_pages))
+        return 0.0;
+
+    const auto page_size = static_cast<double>(sysconf(_SC_PAGESIZE));
+    return static_cast<double>(resident_pages) * page_size / (1024.0 * 1024.0);
+#else
+    return 0.0;
+#endif
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static cv::Size source_size(const std::string& chain, const cv::Size& size)
+{
+    // Chains which scale are given half resolution frames, so that they
+    // benchmark a real 2x upscale to the target size, rather than a copy.
+    const bool upscales = chain == "scaling" || chain == "full";
+    return upscales ? cv::Size(size.width / 2, size.height / 2) : size;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static std::shared_ptr<VideoFilter> make_chain(const std::string& chain, const cv::Size& size)
+{
+    ScalingFilterSettings scaling_settings;
+    scaling_settings.output_size = size;
+
+    // NOTE: the scaling chains are fed frames at half the size, see source_size().
+    if(chain == "stabilization")
+        return std::make_shared<StabilizationFilter>();
+    else if(chain == "deblocking")
+        return std::make_shared<DeblockingFilter>();
+    else if(chain == "scaling")
+        return std::make_shared<ScalingFilter>(scaling_settings);
+
+    return std::make_shared<CompositeFilter>(std::initializer_list<std::shared_ptr<VideoFilter>>{
+        std::make_shared<DeblockingFilter>(),
+        std::make_shared<StabilizationFilter>(),
+        std::make_shared<ScalingFilter>(scaling_settings)
+    });
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static PipelineResult run_pipeline(
+    const std::string& chain,
+    const std::string& resolution,
+    const cv::Size& size,
+    const size_t frame_count
+)
+{
+    const cv::Size input_size = source_size(chain, size);
+    SyntheticVideo video(input_size, RANDOM_SEED);
+
+    const double baseline_memory = resident_memory_mb();
+    double peak_memory = baseline_memory;
+
+    auto filter = make_chain(chain, size);
+
+    std::vector<Time> latencies;
+    latencies.reserve(frame_count);
+
+    // NOTE: the outputs are always at the target size, but the jitter is measured in source pixels.
+    const double output_scale = static_cast<double>(size.width) / static_cast<double>(input_size.width);
+    const double measure_scale = static_cast<double>(size.width) / static_cast<double>(MEASURE_WIDTH);
+    const cv::Size measure_size(MEASURE_WIDTH, static_cast<int>(size.height / measure_scale));
+
+    cv::Mat luma, measure_frame, prev_measure_frame;
+    std::optional<size_t> prev_index;
+    double residual_total = 0.0;
+    size_t residual_samples = 0;
+
+    Stopwatch timer;
+    Frame input, output;
+    for(size_t i = 0; i < frame_count + WARMUP_FRAMES; i++)
+    {
+        input = video.next();
+
+        // Time until the GPU has finished, so latency includes all the work.
+        timer.start();
+        filter->process(std::move(input), output);
+        cv::ocl::finish();
+        const auto latency = timer.stop();
+
+        if(i >= WARMUP_FRAMES)
+            latencies.push_back(latency);
+
+        peak_memory = std::max(peak_memory, resident_memory_mb());
+
+        if(output.is_empty())
+            continue;
+
+        // Measure the remaining motion between consecutive outputs. Any
+        // deviation from the smooth ground truth pan is residual jitter.
+        cv::extractChannel(output.data, luma, 0);
+        cv::resize(luma, measure_frame, measure_size, 0, 0, cv::INTER_AREA);
+        measure_frame.convertTo(measure_frame, CV_32F);
+
+        const auto index = static_cast<size_t>(output.timestamp);
+        if(prev_index.has_value() && index > *prev_index)
+        {
+            const auto shift = cv::phaseCorrelate(prev_measure_frame, measure_frame) * (measure_scale / output_scale);
+            const auto residual = shift - video.smooth_shift(*prev_index, index);
+            residual_total += residual.dot(residual);
+            residual_samples++;
+        }
+        std::swap(prev_measure_frame, measure_frame);
+        prev_index = index;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    PipelineResult result;
+    result.chain = chain;
+    result.resolution = resolution;
+    result.frames = latencies.size();
+
+    Time total_time(0);
+    for(const auto& latency : latencies)
+        total_time += latency;
+
+    result.fps = total_time.seconds() > 0 ? static_cast<double>(latencies.size()) / total_time.seconds() : 0.0;
+    result.p50_latency = latencies[latencies.size() / 2];
+    result.p99_latency = latencies[std::min(latencies.size() - 1, (latencies.size() * 99) / 100)];
+    result.max_latency = latencies.back();
+    result.peak_memory_mb = peak_memory - baseline_memory;
+    result.input_jitter = video.jitter_rms();
+    result.residual_jitter = residual_samples > 0 ? std::sqrt(residual_total / static_cast<double>(residual_samples)) : 0.0;
+
+    return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void write_json(std::ostream& stream, const std::vector<PipelineResult>& results)
+{
+    const auto& device = cv::ocl::Device::getDefault();
+    const std::string opencl_device = cv::ocl::useOpenCL() ? device.name() : "none";
+
+    stream << "{\n";
+    stream << "  \"suite\": \"lvk-bench-pipeline\",\n";
+    stream << "  \"timestamp\": \"" << json_escape(Time::Timestamp()) << "\",\n";
+    stream << "  \"opencv_version\": \"" << CV_VERSION << "\",\n";
+    stream << "  \"opencl_device\": \"" << json_escape(opencl_device) << "\",\n";
+    stream << "  \"pipelines\": [\n";
+
+    stream << std::fixed << std::setprecision(3);
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const auto& result = results[i];
+        stream << "    {"
+               << "\"chain\": \"" << json_escape(result.chain) << "\", "
+               << "\"resolution\": \"" << json_escape(result.resolution) << "\", "
+               << "\"frames\": " << result.frames << ", "
+               << "\"fps\": " << result.fps << ", "
+               << "\"p50_latency_ms\": " << result.p50_latency.milliseconds() << ", "
+               << "\"p99_latency_ms\": " << result.p99_latency.milliseconds() << ", "
+               << "\"max_latency_ms\": " << result.max_latency.milliseconds() << ", "
+               << "\"peak_memory_mb\": " << result.peak_memory_mb << ", "
+               << "\"input_jitter_px\": " << result.input_jitter << ", "
+               << "\"residual_jitter_px\": " << result.residual_jitter
+               << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    stream << "  ]\n";
+    stream << "}\n";
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+static void print_usage()
+{
+    std::cerr << "Usage: lvk-bench-pipeline [-n frames] [-s 720p|1080p|4K] [-c chain] [-o output.json]\n\n"
+              << "  -n  Number of measured frames per pipeline (default 300)\n"
+              << "  -s  Only run the given resolution, may be repeated\n"
+              << "  -c  Only run the given chain (stabilization, deblocking, scaling, full), may be repeated\n"
+              << "  -o  Write the JSON results to a file instead of the standard output\n";
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> resolutions, chains;
+    std::string output_path;
+    size_t frame_count = 300;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string option = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if(option == "-n" && has_value)
+            frame_count = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        else if(option == "-s" && has_value)
+            resolutions.emplace_back(argv[++i]);
+        else if(option == "-c" && has_value)
+            chains.emplace_back(argv[++i]);
+        else if(option == "-o" && has_value)
+            output_path = argv[++i];
+        else
+        {
+            print_usage();
+            return option == "-h" ? 0 : 1;
+        }
+    }
+
+    lvk::context::assert_handler = [](auto, auto, const std::string& assertion){
+        std::cerr << cv::format("LiveVisionKit failed condition: %s\n", assertion.c_str());
+        std::abort();
+    };
+
+    const auto selected = [](const std::vector<std::string>& selection, const std::string& item){
+        return selection.empty() || std::find(selection.begin(), selection.end(), item) != selection.end();
+    };
+
+    std::vector<PipelineResult> results;
+    for(const auto& [resolution, size] : FRAME_SIZES)
+    {
+        if(!selected(resolutions, resolution))
+            continue;
+
+        for(const auto& chain : FILTER_CHAINS)
+        {
+            if(!selected(chains, chain))
+                continue;
+
+            const auto& result = results.emplace_back(run_pipeline(chain, resolution, size, frame_count));
+
+            // Progress goes to the error stream, leaving the output stream for the JSON.
+            std::cerr << std::left << std::setw(16) << chain << std::setw(8) << resolution
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(10) << result.fps << "fps"
+                      << "  p50 " << result.p50_latency.milliseconds() << "ms"
+                      << "  p99 " << result.p99_latency.milliseconds() << "ms"
+                      << "  peak " << result.peak_memory_mb << "MB"
+                      << "  jitter " << result.input_jitter << "px -> " << result.residual_jitter << "px\n";
+        }
+    }
+
+    if(output_path.empty())
+    {
+        write_json(std::cout, results);
+        return 0;
+    }
+
+    std::ofstream output_file(output_path);
+    if(!output_file.good())
+    {
+        std::cerr << "Failed to open output file \'" << output_path << "\'\n";
+        return 1;
+    }
+    write_json(output_file, results);
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
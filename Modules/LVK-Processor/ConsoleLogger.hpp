@@ -26,7 +26,7 @@ namespace clt
     {
     public:
 
-        ConsoleLogger();
+        explicit ConsoleLogger(std::ostream& stream = std::cout);
 
         ~ConsoleLogger() noexcept override;
 
@@ -0,0 +1,147 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "FrameWriter.hpp"
+
+namespace clt
+{
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    FrameWriter::FrameWriter(
+        std::function<void(const cv::UMat&)> sink,
+        const size_t queue_size,
+        const bool drop_frames
+    )
+        : m_Sink(std::move(sink)),
+          m_QueueSize(queue_size),
+          m_DropFrames(drop_frames)
+    {
+        LVK_ASSERT(m_Sink);
+        LVK_ASSERT(queue_size > 0);
+
+        m_EncoderThread = std::thread(&FrameWriter::run_encoder, this);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    FrameWriter::~FrameWriter()
+    {
+        finish();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool FrameWriter::push(cv::UMat&& frame)
+    {
+        std::unique_lock<std::mutex> queue_lock(m_QueueMutex);
+        LVK_ASSERT(!m_Finished);
+
+        if(m_Queue.size() >= m_QueueSize)
+        {
+            // If the encoder has fallen behind, either drop the frame
+            // or wait until the encoder has consumed a queued frame.
+            if(m_DropFrames)
+            {
+                m_DroppedFrames++;
+                return false;
+            }
+
+            while(m_Queue.size() >= m_QueueSize)
+                m_ConsumeFlag.wait(queue_lock);
+        }
+
+        m_Queue.push(std::move(frame));
+        if(m_Queue.size() == 1)
+            m_AvailableFlag.notify_one();
+
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameWriter::finish()
+    {
+        // Let the encoder drain the remaining frames, then wait for it to finish.
+        {
+            std::unique_lock<std::mutex> queue_lock(m_QueueMutex);
+            m_Finished = true;
+            m_AvailableFlag.notify_one();
+        }
+
+        if(m_EncoderThread.joinable())
+            m_EncoderThread.join();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t FrameWriter::queue_depth() const
+    {
+        std::unique_lock<std::mutex> queue_lock(m_QueueMutex);
+        return m_Queue.size();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t FrameWriter::queue_size() const
+    {
+        return m_QueueSize;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t FrameWriter::dropped_frames() const
+    {
+        std::unique_lock<std::mutex> queue_lock(m_QueueMutex);
+        return m_DroppedFrames;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void FrameWriter::run_encoder()
+    {
+        lvk::trace::name_thread("Encoder");
+
+        cv::UMat frame;
+        while(true)
+        {
+            // Pop the next frame from the queue
+            {
+                std::unique_lock<std::mutex> queue_lock(m_QueueMutex);
+                while(m_Queue.empty())
+                {
+                    // If there are no new frames incoming, then we have written everything
+                    if(m_Finished)
+                        return;
+
+                    m_AvailableFlag.wait(queue_lock);
+                }
+
+                frame = std::move(m_Queue.front());
+                m_Queue.pop();
+
+                m_ConsumeFlag.notify_one();
+            }
+
+            LVK_TRACE("Encode");
+            m_Sink(frame);
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,79 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <LiveVisionKit.hpp>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <queue>
+
+namespace clt
+{
+
+    // Writes frames to an output sink on a dedicated encoder thread,
+    // so that slow encodes do not block the rest of the pipeline.
+    class FrameWriter
+    {
+    public:
+
+        FrameWriter(
+            std::function<void(const cv::UMat&)> sink,
+            const size_t queue_size,
+            const bool drop_frames
+        );
+
+        ~FrameWriter();
+
+        FrameWriter(const FrameWriter&) = delete;
+
+        FrameWriter& operator=(const FrameWriter&) = delete;
+
+
+        // NOTE: returns false if the frame was dropped.
+        bool push(cv::UMat&& frame);
+
+        void finish();
+
+
+        size_t queue_depth() const;
+
+        size_t queue_size() const;
+
+        uint64_t dropped_frames() const;
+
+    private:
+
+        void run_encoder();
+
+    private:
+        std::function<void(const cv::UMat&)> m_Sink;
+        const size_t m_QueueSize;
+        const bool m_DropFrames;
+
+        mutable std::mutex m_QueueMutex;
+        std::queue<cv::UMat> m_Queue;
+        std::condition_variable m_ConsumeFlag, m_AvailableFlag;
+
+        bool m_Finished = false;
+        uint64_t m_DroppedFrames = 0;
+        std::thread m_EncoderThread;
+    };
+
+}
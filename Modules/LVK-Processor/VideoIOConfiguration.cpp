@@ -97,7 +97,12 @@ namespace clt
 
         // Parse the input target
         std::optional<std::string> input_format;
-        if(std::filesystem::path path = input; path.has_filename() && path.has_extension())
+        if(input == "-")
+        {
+            // Input is a YUV4MPEG2 stream on stdin
+            input_source = std::filesystem::path(input);
+        }
+        else if(std::filesystem::path path = input; path.has_filename() && path.has_extension())
         {
             // Input is file path
             input_source = path;
@@ -122,7 +127,13 @@ namespace clt
             // Attempt to parse an output, this is optional so it can safely fail.
             // The output will always be a file path with the same format as the input video
             auto output = std::string(arguments.front());
-            if(std::filesystem::path path = output; path.has_filename() && path.has_extension())
+            if(output == "-")
+            {
+                // Output is a YUV4MPEG2 stream on stdout
+                output_target = std::filesystem::path(output);
+                arguments.pop_front();
+            }
+            else if(std::filesystem::path path = output; path.has_filename() && path.has_extension())
             {
                 // If the input was a video file, restrict the output to match the file format.
                 // This is not an encoding tool, so we can make things easier on ourselves here.
@@ -208,7 +219,10 @@ namespace clt
                   << "\t * Output is an optional video file path to which filtered video data is written. If paired "
                      "with a video file input, they must be of matching extensions. \n"
                   << "\t * If no output is specified, or a device capture input is used, a display window will be used"
-                     " to show output frames. This window can be closed using <escape>, ending all processing."
+                     " to show output frames. This window can be closed using <escape>, ending all processing.\n"
+                  << "\t * YUV4MPEG2 \'.y4m\' and raw planar YUV \'.yuv\' files, or named pipes, are read and written "
+                     "natively without any colour conversions. Use \'-\' as the input or output to stream YUV4MPEG2 "
+                     "through stdin or stdout, in which case the console output is written to stderr."
                   << "\n\n";
 
         std::cout << "Options: \n"
@@ -289,12 +303,43 @@ namespace clt
                 }
                 else
                 {
+                    // A denoiser directly following the stabilizer re-uses its motion, rather than tracking again.
+                    const auto denoiser = std::dynamic_pointer_cast<lvk::DenoisingFilter>(filter);
+                    if(denoiser != nullptr && !filter_chain.empty())
+                    {
+                        if(auto stabilizer = std::dynamic_pointer_cast<lvk::StabilizationFilter>(filter_chain.back()))
+                        {
+                            denoiser->reconfigure([&](lvk::DenoisingFilterSettings& settings){
+                                settings.motion_source = std::move(stabilizer);
+                            });
+                        }
+                    }
+
                     filter_chain.push_back(filter);
                     return true;
                 }
             }
         );
 
+        m_OptionParser.add_variable<std::string>(
+            "-R",
+            "Used to specify the WxH resolution of raw planar YUV420 \'.yuv\' inputs. "
+            "The input framerate is taken from the output framerate, defaulting to 30 FPS.",
+            [this](const std::string& resolution)
+            {
+                int width = 0, height = 0;
+                if(std::sscanf(resolution.c_str(), "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+                {
+                    m_ParserError = cv::format(
+                        "Invalid raw input resolution, expected WxH, got \'%s\'",
+                        resolution.c_str()
+                    );
+                    return;
+                }
+                raw_input_size = cv::Size(width, height);
+            }
+        );
+
         m_OptionParser.add_switch(
             "-d",
             "Runs all filters in debug mode, allowing for more "
@@ -302,6 +347,23 @@ namespace clt
             &debug_mode
         );
 
+        m_OptionParser.add_variable<int>(
+            "-j",
+            "Used to specify the integer amount of threads on which stateless filters, such as deblocking "
+            "and scaling, process consecutive frames concurrently. Each thread adds one frame of delay.",
+            [this](const int threads) {
+                if(threads <= 0)
+                {
+                    m_ParserError = cv::format(
+                        "Thread count cannot be zero or negative, got \'%d\'",
+                        threads
+                    );
+                    return;
+                }
+                parallel_threads = static_cast<size_t>(threads);
+            }
+        );
+
         // Output Options
         m_OptionParser.add_variable<int>(
             "-r",
@@ -334,6 +396,28 @@ namespace clt
             }
         );
 
+        m_OptionParser.add_variable<int>(
+            "-q",
+            "Used to specify the integer amount of frames that can be queued up for encoding.",
+            [this](const int frames) {
+                if(frames <= 0)
+                {
+                    m_ParserError = cv::format(
+                        "Output queue size cannot be zero or negative, got \'%d\' frames",
+                        frames
+                    );
+                    return;
+                }
+                output_queue_size = static_cast<size_t>(frames);
+            }
+        );
+
+        m_OptionParser.add_switch(
+            "-Q",
+            "Drops output frames when the encoder falls behind, instead of waiting for it.",
+            &drop_output_frames
+        );
+
         m_OptionParser.add_switch(
             "-C",
             "Lists the fourcc codes of all available encoders.",
@@ -395,20 +479,118 @@ namespace clt
 
         m_OptionParser.add_variable<std::string>(
             "-L",
-            "Turns on filter timing-data logging to the specified CSV filepath.",
+            "Turns on filter timing-data logging to the specified CSV filepath. "
+            "A \'.bin\' filepath instead logs in a binary columnar format.",
             [this](const std::string& path_arg)
             {
                 const std::filesystem::path path = path_arg;
-                if(path.extension() != ".csv")
+                if(path.extension() != ".csv" && path.extension() != ".bin")
                 {
                     m_ParserError = cv::format(
-                        "Invalid data logging target, got file type %s, expected \'.csv\'",
+                        "Invalid data logging target, got file type %s, expected \'.csv\' or \'.bin\'",
                         path.extension().string().c_str()
                     );
                 }
                 log_target = path;
             }
         );
+
+        m_OptionParser.add_variable<std::string>(
+            "-T",
+            "Records a timeline of the processing threads and filters to the specified JSON filepath, "
+            "which can be viewed in chrome://tracing or the Perfetto trace viewer.",
+            [this](const std::string& path_arg)
+            {
+                const std::filesystem::path path = path_arg;
+                if(path.extension() != ".json")
+                {
+                    m_ParserError = cv::format(
+                        "Invalid trace target, got file type %s, expected \'.json\'",
+                        path.extension().string().c_str()
+                    );
+                }
+                trace_target = path;
+            }
+        );
+
+        // Calibration Options
+
+        m_OptionParser.add_variable<std::string>(
+            "-K",
+            "Calibrates the camera from the chessboard patterns seen in the output, saving the "
+            "calibration profile to the specified \'.yml\', \'.json\' or \'.xml\' filepath.",
+            [this](const std::string& path_arg)
+            {
+                const std::filesystem::path path = path_arg;
+                if(path.extension() != ".yml" && path.extension() != ".json" && path.extension() != ".xml")
+                {
+                    m_ParserError = cv::format(
+                        "Invalid calibration target, got file type %s, expected \'.yml\', \'.json\' or \'.xml\'",
+                        path.extension().string().c_str()
+                    );
+                }
+                calibration_target = path;
+            }
+        );
+
+        m_OptionParser.add_parser(
+            "-Kp",
+            "Specifies the number of inner corners along the columns and rows of the calibration "
+            "chessboard pattern, defaults to 9 6.",
+            [this](ArgQueue& arguments)
+            {
+                // Pop '-Kp' from the arguments queue
+                arguments.pop_front();
+
+                int columns = 0, rows = 0;
+                if(arguments.size() >= 2)
+                {
+                    std::stringstream(arguments[0]) >> columns;
+                    std::stringstream(arguments[1]) >> rows;
+                }
+
+                if(columns < 2 || rows < 2)
+                {
+                    m_ParserError = "Invalid calibration pattern, expected two integers greater than one after -Kp";
+                    return false;
+                }
+
+                arguments.pop_front();
+                arguments.pop_front();
+
+                calibration_pattern = cv::Size(columns, rows);
+                return true;
+            }
+        );
+
+        m_OptionParser.add_variable<int>(
+            "-Ks",
+            "Specifies the size of the calibration chessboard's squares, in any unit of length.",
+            [this](const int size)
+            {
+                if(size <= 0)
+                {
+                    m_ParserError = cv::format("Invalid calibration square size, got %d, expected a positive integer", size);
+                    return;
+                }
+                calibration_square_size = static_cast<uint32_t>(size);
+            }
+        );
+
+        m_OptionParser.add_variable<int>(
+            "-Kn",
+            "Specifies that only every n-th frame is searched for the calibration pattern, defaults to 1. "
+            "The search also stops once enough patterns have been found.",
+            [this](const int stride)
+            {
+                if(stride <= 0)
+                {
+                    m_ParserError = cv::format("Invalid calibration frame stride, got %d, expected a positive integer", stride);
+                    return;
+                }
+                calibration_stride = static_cast<uint32_t>(stride);
+            }
+        );
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -435,6 +617,21 @@ namespace clt
                     "The amount of camera smoothing to apply to the video.",
                     &config.path_prediction_frames
                 );
+                config_parser.add_variable(
+                    {".rolling_shutter", ".rs"},
+                    "The number of row bands used to correct rolling shutter wobble, zero disables the correction.",
+                    &config.rolling_shutter_bands
+                );
+                config_parser.add_switch(
+                    {".spill_host", ".sh"},
+                    "Keeps the delayed frames in host memory, bounding the GPU memory used at high smoothing",
+                    [&config](){ config.frame_storage = lvk::FrameStorage::HOST; }
+                );
+                config_parser.add_switch(
+                    {".spill_file", ".sf"},
+                    "Keeps the delayed frames in a memory-mapped temporary file, bounding the memory used",
+                    [&config](){ config.frame_storage = lvk::FrameStorage::MAPPED_FILE; }
+                );
             }
         );
 
@@ -447,6 +644,75 @@ namespace clt
                     "Used to specify the number of deblocking passes to perform.",
                     &config.detection_levels
                 );
+                config_parser.add_variable(
+                    {".cache", ".c"},
+                    "Used to specify the cache budget, in KiB, of the tiles filtered in parallel on the CPU. "
+                    "It should be at most the per-core L2 cache size, zero disables tiling.",
+                    &config.cpu_cache_budget
+                );
+            }
+        );
+
+        m_FilterParser.add_filter<lvk::DenoisingFilter, lvk::DenoisingFilterSettings>(
+            {"mctd", "denoiser"},
+            "A motion compensated temporal denoising filter used to lessen the effect of sensor noise. "
+            "When it directly follows the stabilization filter, it re-uses the stabilizer's motion instead "
+            "of tracking the frames again.",
+            [](clt::OptionsParser& config_parser, lvk::DenoisingFilterSettings& config){
+                config_parser.add_variable(
+                    {".strength", ".s"},
+                    "Used to specify the weight, from 0 to 1, of the previous frames in the denoised result.",
+                    &config.strength
+                );
+                config_parser.add_variable(
+                    {".threshold", ".t"},
+                    "Used to specify the 8-bit luma difference at which a pixel is treated as changed rather than noisy.",
+                    &config.change_threshold
+                );
+            }
+        );
+
+        m_FilterParser.add_filter<lvk::FrameRateFilter, lvk::FrameRateFilterSettings>(
+            {"fri", "interpolator"},
+            "A motion compensated frame interpolation filter used to raise the framerate of the video.",
+            [](clt::OptionsParser& config_parser, lvk::FrameRateFilterSettings& config){
+                config_parser.add_variable(
+                    {".multiplier", ".m"},
+                    "Used to specify the number of output frames per input frame, e.g. 2 for 30 to 60 FPS.",
+                    &config.rate_multiplier
+                );
+            }
+        );
+
+        m_FilterParser.add_filter<lvk::LensCorrectionFilter, lvk::LensCorrectionFilterSettings>(
+            {"lc", "lens"},
+            "A lens correction filter used to remove the lens distortion described by a camera calibration profile.",
+            [](clt::OptionsParser& config_parser, lvk::LensCorrectionFilterSettings& config){
+                config_parser.add_parser(
+                    {".profile", ".p"},
+                    "Used to specify the camera calibration profile file describing the lens distortion.",
+                    [&config](ArgQueue& arguments)
+                    {
+                        if(arguments.size() < 2)
+                            return false;
+
+                        auto parameters = lvk::load_camera_parameters(arguments[1]);
+                        if(!parameters.has_value())
+                            return false;
+
+                        config.camera_parameters = std::move(*parameters);
+
+                        // Pop the option and the profile path from the arguments queue
+                        arguments.pop_front();
+                        arguments.pop_front();
+                        return true;
+                    }
+                );
+                config_parser.add_switch(
+                    {".no_cache", ".nc"},
+                    "Specifies that the fitted correction fields should not be cached to disk",
+                    [&config](){ config.cache_fields = false; }
+                );
             }
         );
     }
@@ -33,13 +33,17 @@ namespace clt
     {
         // Input / Process Settings
         std::variant<std::monostate, std::filesystem::path, uint32_t> input_source;
+        std::optional<cv::Size> raw_input_size;
         std::vector<std::shared_ptr<lvk::VideoFilter>> filter_chain;
         bool debug_mode = false;
+        size_t parallel_threads = 1;
 
         // Output Settings
         std::optional<std::filesystem::path> output_target;
         std::optional<double> output_framerate;
         std::optional<int> output_codec;
+        size_t output_queue_size = 8;
+        bool drop_output_frames = false;
 
         bool render_output = false;
         std::optional<lvk::Time> render_period;
@@ -48,9 +52,16 @@ namespace clt
         bool print_progress = true;
         bool print_timings = false;
         std::optional<std::filesystem::path> log_target;
+        std::optional<std::filesystem::path> trace_target;
 
         lvk::Time update_period = lvk::Time::Seconds(0.5);
 
+        // Calibration Settings
+        std::optional<std::filesystem::path> calibration_target;
+        cv::Size calibration_pattern = {9, 6};
+        uint32_t calibration_square_size = 1;
+        uint32_t calibration_stride = 1;
+
     public:
 
         VideoIOConfiguration();
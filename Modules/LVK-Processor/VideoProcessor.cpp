@@ -18,6 +18,7 @@
 #include "VideoProcessor.hpp"
 
 #include <type_traits>
+#include <future>
 #include <utility>
 
 namespace clt
@@ -27,10 +28,15 @@ namespace clt
     constexpr size_t FILTER_TIMING_SAMPLES = 300;
     constexpr const char* RENDER_WINDOW_NAME = "LVK Output";
 
+    const int I420_FORMAT = cv::VideoWriter::fourcc('I', '4', '2', '0');
+    const int NV12_FORMAT = cv::VideoWriter::fourcc('N', 'V', '1', '2');
+
 //---------------------------------------------------------------------------------------------------------------------
 
     VideoProcessor::VideoProcessor(VideoIOConfiguration configuration)
-        : m_Configuration(std::move(configuration))
+        : m_Configuration(std::move(configuration)),
+          // Keep stdout clean if it is being used for output
+          m_ConsoleLogger(m_Configuration.output_target == std::filesystem::path("-") ? std::cerr : std::cout)
     {}
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -44,15 +50,43 @@ namespace clt
 
             if constexpr(std::is_same_v<source_type, std::filesystem::path>)
             {
+                m_DeviceCapture = false;
+                if(is_yuv_stream(source))
+                {
+                    m_YUVInput = true;
+                    input_error = m_YUVInputStream.open(source, YUVStreamFormat{
+                        .size = m_Configuration.raw_input_size.value_or(cv::Size()),
+                        .framerate = m_Configuration.output_framerate.value_or(30.0)
+                    });
+                    return;
+                }
+
                 std::vector<int> properties = {
                     cv::CAP_PROP_HW_ACCELERATION, 1,
                     cv::CAP_PROP_HW_ACCELERATION_USE_OPENCL, 1
                 };
 
-                m_DeviceCapture = false;
                 m_InputStream = cv::VideoCapture(source.string(), cv::CAP_FFMPEG, properties);
                 if(!m_InputStream.isOpened())
+                {
                     input_error = cv::format("Failed to open the input video \'%s\'", source.string().c_str());
+                    return;
+                }
+
+                // Ask the decoder for its native 4:2:0 frames, so that they can be packed into
+                // YUV directly instead of making a round trip through BGR. Hardware decoders
+                // hand back NV12, while software decoders use the codec's pixel format.
+                const bool hardware_decoding =
+                    m_InputStream.get(cv::CAP_PROP_HW_ACCELERATION) != cv::VIDEO_ACCELERATION_NONE;
+
+                const int pixel_format = hardware_decoding
+                    ? NV12_FORMAT : static_cast<int>(m_InputStream.get(cv::CAP_PROP_CODEC_PIXEL_FORMAT));
+
+                if((pixel_format == I420_FORMAT || pixel_format == NV12_FORMAT)
+                    && m_InputStream.set(cv::CAP_PROP_CONVERT_RGB, 0))
+                {
+                    m_NativeFormat = pixel_format;
+                }
             }
             else if constexpr(std::is_same_v<source_type, uint32_t>)
             {
@@ -68,33 +102,72 @@ namespace clt
         if(input_error.has_value())
             return input_error;
 
+        m_YUVOutput = m_Configuration.output_target.has_value() && is_yuv_stream(*m_Configuration.output_target);
+
+        // Stateless filters can be run on multiple threads to process several frames at once.
+        const auto parallelize = [this](std::shared_ptr<lvk::VideoFilter> filter) -> std::shared_ptr<lvk::VideoFilter>
+        {
+            if(m_Configuration.parallel_threads > 1 && filter->is_stateless())
+                return std::make_shared<lvk::ParallelFilter>(filter, m_Configuration.parallel_threads);
+
+            return filter;
+        };
+
         // Configure the filter
+        // NOTE: LVK filters run on packed YUV, all colour conversions
+        // are handled by the input and output streams instead.
         m_Processor.reconfigure([&](lvk::CompositeFilterSettings& settings){
-            // Add BGR to YUV conversion as LVK filters run on a YUV standard
-            settings.filter_chain.emplace_back(
-                new lvk::ConversionFilter(lvk::ConversionFilterSettings{.conversion_code=cv::COLOR_BGR2YUV})
-            );
-
             for(auto& filter : m_Configuration.filter_chain)
             {
                 filter->set_timing_samples(FILTER_TIMING_SAMPLES);
-                settings.filter_chain.push_back(filter);
-            }
 
-            // Convert back to BGR OpenCV standard for output
-            settings.filter_chain.emplace_back(
-                new lvk::ConversionFilter(lvk::ConversionFilterSettings{.conversion_code=cv::COLOR_YUV2BGR})
-            );
+                // NOTE: the GPU work is only timed if the timings are being reported.
+                filter->set_gpu_timing(m_Configuration.print_timings || m_Configuration.log_target.has_value());
+                settings.filter_chain.push_back(parallelize(filter));
+            }
         });
 
+        // NOTE: the calibrator detects patterns on its own threads, off the processing path.
+        if(m_Configuration.calibration_target.has_value())
+        {
+            m_Calibrator.emplace(lvk::CameraCalibratorSettings{
+                .pattern_size = m_Configuration.calibration_pattern,
+                .frame_stride = m_Configuration.calibration_stride
+            });
+        }
+
         // Load data logger
         if(m_Configuration.log_target.has_value())
         {
-            m_DataLogStream.open(*m_Configuration.log_target);
-            if(!m_DataLogStream.good())
-                return "Failed to open data logging stream";
+            // Format is..
+            // 1. Output Frame Number
+            // 2. Processor frametime
+            // 3. All filter frametimes
+            // 4. Processor deviation
+            // 5. All filter deviations
+            // 6. All filter p99 frametimes
+            std::vector<std::string> columns;
+            columns.emplace_back("Output Frame");
 
-            m_DataLogger.emplace(m_DataLogStream);
+            columns.emplace_back("Processor Frametime (ms)");
+            for(auto& filter : m_Processor.filters())
+                columns.push_back(filter->alias() + " Frametime (ms)");
+
+            columns.emplace_back("Processor Deviation (ms)");
+            for(auto& filter : m_Processor.filters())
+                columns.push_back(filter->alias() + " Deviation (ms)");
+
+            for(auto& filter : m_Processor.filters())
+                columns.push_back(filter->alias() + " P99 Frametime (ms)");
+
+            const auto format = m_Configuration.log_target->extension() == ".bin"
+                ? lvk::AsyncCSVLogger::Format::BINARY_COLUMNAR
+                : lvk::AsyncCSVLogger::Format::CSV;
+
+            m_DataRecord.reserve(columns.size());
+            m_DataLogger.emplace(*m_Configuration.log_target, std::move(columns), format);
+            if(m_DataLogger->has_error())
+                return "Failed to open data logging stream";
         }
 
         return std::nullopt;
@@ -107,6 +180,26 @@ namespace clt
         if(!m_Configuration.output_target.has_value())
             return "Could not create output stream, no target was specified";
 
+        if(m_YUVOutput)
+        {
+            const auto stream_error = m_YUVOutputStream.open(*m_Configuration.output_target, YUVStreamFormat{
+                .size = frame_size,
+                .framerate = output_framerate(),
+                .layout = m_YUVInput ? m_YUVInputStream.format().layout : ChromaLayout::YUV420
+            });
+
+            if(stream_error.has_value())
+                return stream_error;
+
+            m_FrameWriter.emplace(
+                [this](const cv::UMat& frame){ m_YUVOutputStream.write(frame); },
+                m_Configuration.output_queue_size,
+                m_Configuration.drop_output_frames
+            );
+
+            return std::nullopt;
+        }
+
         try {
             std::vector<int> properties = {
                 cv::VideoWriterProperties::VIDEOWRITER_PROP_HW_ACCELERATION, 1,
@@ -117,11 +210,10 @@ namespace clt
                 m_Configuration.output_target->string(),
                 cv::CAP_FFMPEG,
                 m_Configuration.output_codec.value_or(
-                    static_cast<int>(m_InputStream.get(cv::CAP_PROP_FOURCC))
-                ),
-                m_Configuration.output_framerate.value_or(
-                    std::max(m_InputStream.get(cv::CAP_PROP_FPS), 1.0)
+                    m_YUVInput ? cv::VideoWriter::fourcc('m', 'p', '4', 'v')
+                               : static_cast<int>(m_InputStream.get(cv::CAP_PROP_FOURCC))
                 ),
+                output_framerate(),
                 frame_size,
                 properties
             );
@@ -143,9 +235,122 @@ namespace clt
             );
         }
 
+        // NOTE: the BGR conversion is run on the encoder thread, off the processing path.
+        m_FrameWriter.emplace(
+            [this](const cv::UMat& frame){
+                yuv_to_bgr(frame, m_EncodeBuffer);
+                m_OutputStream.write(m_EncodeBuffer);
+            },
+            m_Configuration.output_queue_size,
+            m_Configuration.drop_output_frames
+        );
+
         return std::nullopt;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    double VideoProcessor::input_framerate()
+    {
+        if(m_YUVInput)
+            return m_YUVInputStream.format().framerate;
+
+        return std::max(m_InputStream.get(cv::CAP_PROP_FPS), 1.0);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    double VideoProcessor::output_framerate()
+    {
+        if(m_Configuration.output_framerate.has_value())
+            return *m_Configuration.output_framerate;
+
+        // Frame rate filters output several frames per input, so raise the framerate to match.
+        double framerate = input_framerate();
+        for(const auto& filter : m_Configuration.filter_chain)
+        {
+            if(const auto rate_filter = std::dynamic_pointer_cast<lvk::FrameRateFilter>(filter))
+                framerate *= static_cast<double>(rate_filter->settings().rate_multiplier);
+        }
+
+        return framerate;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool VideoProcessor::read_capture(lvk::Frame& frame)
+    {
+        const double read_position = m_InputStream.get(cv::CAP_PROP_POS_FRAMES);
+        if(!m_InputStream.read(m_CaptureBuffer))
+            return false;
+
+        const cv::Size frame_size(
+            static_cast<int>(m_InputStream.get(cv::CAP_PROP_FRAME_WIDTH)),
+            static_cast<int>(m_InputStream.get(cv::CAP_PROP_FRAME_HEIGHT))
+        );
+        const cv::Size chroma_size = frame_size / 2;
+
+        // Native 4:2:0 frames are returned as a single plane, with the chroma below the luma.
+        const bool native_frame = m_NativeFormat != 0
+            && m_CaptureBuffer.type() == CV_8UC1
+            && m_CaptureBuffer.isContinuous()
+            && m_CaptureBuffer.rows == frame_size.height + chroma_size.height;
+
+        // Some backends ignore the native frame request and only return the luma, so fall
+        // back to BGR frames and re-read the frame. If the stream can't seek back, then
+        // the frame is read from the luma alone, rather than ending the stream early.
+        if(m_NativeFormat != 0 && !native_frame)
+        {
+            m_NativeFormat = 0;
+            m_InputStream.set(cv::CAP_PROP_CONVERT_RGB, 1);
+
+            if(m_InputStream.set(cv::CAP_PROP_POS_FRAMES, read_position))
+            {
+                cv::Mat luma_frame = m_CaptureBuffer;
+                if(!m_InputStream.read(m_CaptureBuffer))
+                    m_CaptureBuffer = luma_frame;
+            }
+        }
+
+        if(native_frame)
+        {
+            uint8_t* y_data = m_CaptureBuffer.data;
+            uint8_t* chroma_data = y_data + frame_size.area();
+
+            cv::Mat(frame_size, CV_8UC1, y_data).copyTo(m_YPlane);
+            if(m_NativeFormat == NV12_FORMAT)
+            {
+                // NV12 interleaves the U and V samples in one plane.
+                cv::split(cv::Mat(chroma_size, CV_8UC2, chroma_data), m_ChromaPlanes);
+                pack_planes(m_YPlane, m_ChromaPlanes[0], m_ChromaPlanes[1], frame.data);
+            }
+            else
+            {
+                cv::Mat(chroma_size, CV_8UC1, chroma_data).copyTo(m_UPlane);
+                cv::Mat(chroma_size, CV_8UC1, chroma_data + chroma_size.area()).copyTo(m_VPlane);
+                pack_planes(m_YPlane, m_UPlane, m_VPlane, frame.data);
+            }
+        }
+        else if(m_CaptureBuffer.type() == CV_8UC3)
+        {
+            // Device captures, and decoders which ignore the native
+            // frame request, still return their frames in BGR.
+            bgr_to_yuv(m_CaptureBuffer, frame.data);
+        }
+        else if(m_CaptureBuffer.type() == CV_8UC1)
+        {
+            // Greyscale frames have no chroma, so it is left neutral.
+            cv::cvtColor(m_CaptureBuffer, m_GreyBuffer, cv::COLOR_GRAY2BGR);
+            bgr_to_yuv(m_GreyBuffer, frame.data);
+        }
+        else return false;
+
+        // Set frame timestamp if supported, otherwise set it to zero.
+        const auto stream_position = std::max(0.0, m_InputStream.get(cv::CAP_PROP_POS_MSEC));
+        frame.timestamp = static_cast<uint64_t>(lvk::Time::Milliseconds(stream_position).nanoseconds());
+        return true;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void VideoProcessor::stop()
@@ -167,80 +372,153 @@ namespace clt
         if(m_Configuration.render_output)
             cv::namedWindow(RENDER_WINDOW_NAME, cv::WINDOW_NORMAL | cv::WINDOW_KEEPRATIO);
 
+        if(m_Configuration.trace_target.has_value())
+            lvk::trace::start();
+
         m_FrameTimer.start();
         m_ProcessTimer.start();
         lvk::Time last_update_time;
 
         // Run the processor filter
         m_Terminate = false;
-        m_Processor.process(
-            m_InputStream,
-            [&, this](lvk::VideoFilter& filter, lvk::Frame& frame)
+        const auto output_callback = [&, this](lvk::VideoFilter& filter, lvk::Frame& frame)
+        {
+            // Write output
+            if(m_Configuration.output_target.has_value())
             {
-
-                // Write output
-                if(m_Configuration.output_target.has_value())
+                // Lazily initialize the output stream on first output frame
+                if(!m_FrameWriter.has_value())
                 {
-                    // Lazily initialize the output stream on first output frame
-                    if(!m_OutputStream.isOpened())
-                    {
-                        runtime_error = initialize_output_stream(frame.size());
-                        if(runtime_error.has_value())
-                            return true;
-                    }
-
-                    m_OutputStream.write(frame.data);
+                    runtime_error = initialize_output_stream(frame.size());
+                    if(runtime_error.has_value())
+                        return true;
                 }
 
-                // Display output
-                if(m_Configuration.render_output)
-                {
-                    cv::imshow(RENDER_WINDOW_NAME, frame.data);
-
-                    // Close display if escape is pressed, also note that
-                    // the poll event is required to update the window.
-                    if(const auto key = cv::pollKey(); key == 27)
-                    {
-                        m_Configuration.render_output = false;
-                        cv::destroyAllWindows();
-
-                        // If the input is a device capture or there is no output path, then
-                        // we consider the display to the output. So closing the window should
-                        // also terminate the processing. This is so that we can decide when to
-                        // end indefinite device capture streams, and to avoid accidentally
-                        // leaving the processor running in the background indefinitely.
-                        return m_DeviceCapture || !m_Configuration.output_target.has_value();
-                    }
-                }
+                // NOTE: the frame data is shared with the encoder thread, this is safe
+                // as the processor never writes into an output frame after delivery.
+                m_FrameWriter->push(cv::UMat(frame.data));
+            }
 
-                // Update the frame timer
-                if(m_Configuration.render_output && m_Configuration.render_period.has_value())
-                {
-                    // If we are displaying the output at a fixed frequency,
-                    // then we need to wait to match the user's timestep here.
-                    m_FrameTimer.tick(*m_Configuration.render_period);
-                }
-                else m_FrameTimer.tick();
+            // Feed the calibrator
+            if(m_Calibrator.has_value())
+                m_Calibrator->submit(frame.data);
+
+            // Display output
+            if(m_Configuration.render_output)
+            {
+                yuv_to_bgr(frame.data, m_DisplayBuffer);
+                cv::imshow(RENDER_WINDOW_NAME, m_DisplayBuffer);
 
-                // Run all update procedures (logging etc.)
-                const auto elapsed_time = m_ProcessTimer.elapsed();
-                if(last_update_time.is_zero() || elapsed_time > last_update_time + m_Configuration.update_period)
+                // Close display if escape is pressed, also note that
+                // the poll event is required to update the window.
+                if(const auto key = cv::pollKey(); key == 27)
                 {
-                    last_update_time = elapsed_time;
-                    write_to_loggers();
+                    m_Configuration.render_output = false;
+                    cv::destroyAllWindows();
+
+                    // If the input is a device capture or there is no output path, then
+                    // we consider the display to the output. So closing the window should
+                    // also terminate the processing. This is so that we can decide when to
+                    // end indefinite device capture streams, and to avoid accidentally
+                    // leaving the processor running in the background indefinitely.
+                    return m_DeviceCapture || !m_Configuration.output_target.has_value();
                 }
+            }
 
-                return m_Terminate;
-            },
-            m_Configuration.debug_mode
-        );
+            // Update the frame timer
+            if(m_Configuration.render_output && m_Configuration.render_period.has_value())
+            {
+                // If we are displaying the output at a fixed frequency,
+                // then we need to wait to match the user's timestep here.
+                m_FrameTimer.tick(*m_Configuration.render_period);
+            }
+            else m_FrameTimer.tick();
+
+            // Run all update procedures (logging etc.)
+            const auto elapsed_time = m_ProcessTimer.elapsed();
+            if(last_update_time.is_zero() || elapsed_time > last_update_time + m_Configuration.update_period)
+            {
+                last_update_time = elapsed_time;
+                write_to_loggers();
+            }
+
+            return m_Terminate;
+        };
+
+        if(m_YUVInput)
+        {
+            m_Processor.process(
+                [this](lvk::Frame& frame){ return m_YUVInputStream.read(frame); },
+                output_callback,
+                m_Configuration.debug_mode
+            );
+        }
+        else
+        {
+            m_Processor.process(
+                [this](lvk::Frame& frame){ return read_capture(frame); },
+                output_callback,
+                m_Configuration.debug_mode
+            );
+        }
+
+        // Calibrate in the background while the encoder writes out all the queued frames.
+        std::future<std::optional<std::string>> calibration;
+        if(m_Calibrator.has_value())
+            calibration = std::async(std::launch::async, &VideoProcessor::save_calibration, this);
+
+        if(m_FrameWriter.has_value())
+            m_FrameWriter->finish();
+        m_YUVOutputStream.close();
+
+        if(calibration.valid())
+        {
+            if(auto calibration_error = calibration.get(); calibration_error.has_value() && !runtime_error.has_value())
+                runtime_error = calibration_error;
+        }
 
         // Run loggers one last time to ensure we have the latest statistics displayed.
         write_to_loggers();
 
+        if(m_DataLogger.has_value())
+        {
+            m_DataLogger->flush();
+            if(m_DataLogger->has_error() && !runtime_error.has_value())
+                runtime_error = "Failed to write the timing data log";
+        }
+
+        if(m_Configuration.trace_target.has_value())
+        {
+            lvk::trace::stop();
+            if(!lvk::trace::dump(*m_Configuration.trace_target) && !runtime_error.has_value())
+            {
+                runtime_error = cv::format(
+                    "Failed to write the trace to \'%s\'",
+                    m_Configuration.trace_target->string().c_str()
+                );
+            }
+        }
+
         return runtime_error;
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::optional<std::string> VideoProcessor::save_calibration()
+    {
+        const auto& target = *m_Configuration.calibration_target;
+
+        m_Calibrator->wait();
+        if(m_Calibrator->calibration_frames() == 0)
+            return "Failed to calibrate, no calibration patterns were found in the video";
+
+        const auto parameters = m_Calibrator->calibrate(m_Configuration.calibration_square_size);
+        if(!lvk::save_camera_parameters(parameters, target.string()))
+            return cv::format("Failed to write the calibration profile to \'%s\'", target.string().c_str());
+
+        return std::nullopt;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     void VideoProcessor::write_to_loggers()
@@ -259,23 +537,35 @@ namespace clt
 
     void VideoProcessor::print_progress()
     {
-        // NOTE: The frame count is not valid for device capture streams
-        double frame_count = m_InputStream.get(cv::CAP_PROP_FRAME_COUNT);
-        double frame_number = m_InputStream.get(cv::CAP_PROP_POS_FRAMES);
+        // NOTE: The frame count is not valid for device capture streams, nor for piped YUV streams.
+        double frame_count = 0, frame_number = 0;
+        if(m_YUVInput)
+        {
+            frame_count = static_cast<double>(m_YUVInputStream.frame_count());
+            frame_number = static_cast<double>(m_YUVInputStream.frames_read());
+        }
+        else
+        {
+            frame_count = m_InputStream.get(cv::CAP_PROP_FRAME_COUNT);
+            frame_number = m_InputStream.get(cv::CAP_PROP_POS_FRAMES);
+        }
+        const bool known_length = !m_DeviceCapture && frame_count > 0;
 
         // Input Stream Info
         m_ConsoleLogger << "Processing target: ";
         if(!m_DeviceCapture)
         {
-            m_ConsoleLogger << std::get<std::filesystem::path>(m_Configuration.input_source).string()
-                            << "  " << make_progress_bar(40, frame_number / frame_count)
-                            << ConsoleLogger::Next;
+            const auto& source = std::get<std::filesystem::path>(m_Configuration.input_source);
+            m_ConsoleLogger << (source == "-" ? "stdin" : source.string());
+            if(known_length)
+                m_ConsoleLogger << "  " << make_progress_bar(40, frame_number / frame_count);
+            m_ConsoleLogger << ConsoleLogger::Next;
         }
         else m_ConsoleLogger << "Device Capture" << ConsoleLogger::Next;
 
         // Print Elapsed time
         m_ConsoleLogger << "   Elapsed: " << m_ProcessTimer.elapsed().hms();
-        if(!m_DeviceCapture)
+        if(known_length)
         {
             lvk::Time est_remaining_time = lvk::Time::Seconds(
                 std::ceil((frame_count - frame_number) / m_FrameTimer.average().frequency())
@@ -296,6 +586,18 @@ namespace clt
         m_ConsoleLogger << "   FPS: "
                         << std::fixed << std::setprecision(0) << m_FrameTimer.average().frequency()
                         << ConsoleLogger::Next;
+
+        // Print encoder queue depth
+        if(m_FrameWriter.has_value())
+        {
+            m_ConsoleLogger << "   Output Queue: "
+                            << m_FrameWriter->queue_depth() << "/" << m_FrameWriter->queue_size();
+
+            if(const auto dropped_frames = m_FrameWriter->dropped_frames(); dropped_frames > 0)
+                m_ConsoleLogger << " (" << dropped_frames << " dropped)";
+
+            m_ConsoleLogger << ConsoleLogger::Next;
+        }
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -309,12 +611,16 @@ namespace clt
         {
             auto filter = m_Processor.filters(i);
             auto average_timing = filter->timings().average();
+            const auto& histogram = filter->timings().histogram();
 
             m_ConsoleLogger << std::to_string(i) <<  ".   "
                             << filter->alias()
                             << "\t" << average_timing.milliseconds() << "ms"
                             << " +/- " << filter->timings().deviation().milliseconds() << "ms"
                             << "   (" << static_cast<uint64_t>(average_timing.frequency()) << "FPS)"
+                            << "   p50: " << histogram.percentile(50).milliseconds() << "ms"
+                            << "  p99: " << histogram.percentile(99).milliseconds() << "ms"
+                            << "  max: " << histogram.max().milliseconds() << "ms"
                             << ConsoleLogger::Next;
         }
     }
@@ -325,46 +631,28 @@ namespace clt
     {
         LVK_ASSERT(m_DataLogger.has_value());
 
-        lvk::CSVLogger& logger = *m_DataLogger;
-
-        // On first log, add all the headers as filter names
-        if(!logger.has_started())
-        {
-            // Format is..
-            // 1. Output Frame Number
-            // 2. Processor frametime
-            // 3. All filter frametimes
-            // 4. Processor deviation
-            // 5. All filter deviations
-
-            logger << "Output Frame";
-
-            logger << "Processor Frametime (ms)";
-            for(auto& filter : m_Processor.filters())
-                logger << (filter->alias() + " Frametime (ms)");
-
-            // Then log all the frame deviation times
-            logger << "Processor Deviation (ms)";
-            for(auto& filter : m_Processor.filters())
-                logger << (filter->alias() + " Deviation (ms)");
-
-            logger.next();
-        }
+        // NOTE: the record is only gathered here, formatting and writing
+        // is done by the logger's background thread to avoid frame jitter.
+        m_DataRecord.clear();
 
         // write frame number
-        logger << m_FrameTimer.tick_count();
+        m_DataRecord.push_back(static_cast<double>(m_FrameTimer.tick_count()));
 
         // write all frametimes
-        logger << m_FrameTimer.average().milliseconds();
+        m_DataRecord.push_back(m_FrameTimer.average().milliseconds());
         for(auto& filter : m_Processor.filters())
-            logger << filter->timings().average().milliseconds();
+            m_DataRecord.push_back(filter->timings().average().milliseconds());
 
         // write all frame deviation times
-        logger << m_FrameTimer.deviation().milliseconds();
+        m_DataRecord.push_back(m_FrameTimer.deviation().milliseconds());
+        for(auto& filter : m_Processor.filters())
+            m_DataRecord.push_back(filter->timings().deviation().milliseconds());
+
+        // write all tail frametimes
         for(auto& filter : m_Processor.filters())
-            logger << filter->timings().deviation().milliseconds();
+            m_DataRecord.push_back(filter->timings().histogram().percentile(99).milliseconds());
 
-        logger.next();
+        m_DataLogger->push(m_DataRecord);
     }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -22,6 +22,8 @@
 
 #include "VideoIOConfiguration.hpp"
 #include "ConsoleLogger.hpp"
+#include "FrameWriter.hpp"
+#include "YUVStream.hpp"
 
 namespace clt
 {
@@ -42,6 +44,14 @@ namespace clt
 
         std::optional<std::string> initialize_output_stream(const cv::Size frame_size);
 
+        double input_framerate();
+
+        double output_framerate();
+
+        bool read_capture(lvk::Frame& frame);
+
+        std::optional<std::string> save_calibration();
+
         void write_to_loggers();
 
         void print_progress();
@@ -55,13 +65,25 @@ namespace clt
     private:
         VideoIOConfiguration m_Configuration;
         bool m_DeviceCapture = false;
+        bool m_YUVInput = false, m_YUVOutput = false;
 
-        std::ofstream m_DataLogStream;
-        std::optional<lvk::CSVLogger> m_DataLogger;
+        std::optional<lvk::AsyncCSVLogger> m_DataLogger;
+        std::vector<double> m_DataRecord;
         ConsoleLogger m_ConsoleLogger;
 
         cv::VideoCapture m_InputStream;
         cv::VideoWriter m_OutputStream;
+        YUVStreamReader m_YUVInputStream;
+        YUVStreamWriter m_YUVOutputStream;
+
+        int m_NativeFormat = 0;
+        cv::Mat m_CaptureBuffer, m_GreyBuffer;
+        cv::UMat m_YPlane, m_UPlane, m_VPlane;
+        std::vector<cv::UMat> m_ChromaPlanes;
+        cv::Mat m_DisplayBuffer, m_EncodeBuffer;
+
+        std::optional<FrameWriter> m_FrameWriter;
+        std::optional<lvk::CameraCalibrator> m_Calibrator;
         lvk::CompositeFilter m_Processor;
 
         bool m_Terminate = false;
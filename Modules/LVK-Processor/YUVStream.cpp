@@ -0,0 +1,468 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#include "YUVStream.hpp"
+
+#include <numeric>
+#include <cctype>
+#include <sstream>
+
+#ifdef WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace clt
+{
+//---------------------------------------------------------------------------------------------------------------------
+
+    constexpr const char* Y4M_SIGNATURE = "YUV4MPEG2";
+    constexpr const char* Y4M_FRAME_SIGNATURE = "FRAME";
+    constexpr size_t MAX_Y4M_HEADER_LENGTH = 1024;
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::FILE* open_stream(const std::filesystem::path& path, const bool write, bool& owns_file)
+    {
+        if(path == "-")
+        {
+            std::FILE* stream = write ? stdout : stdin;
+#ifdef WIN32
+            // Windows opens the standard streams in text mode, which mangles binary data.
+            _setmode(_fileno(stream), _O_BINARY);
+#endif
+            owns_file = false;
+            return stream;
+        }
+
+        owns_file = true;
+        return std::fopen(path.string().c_str(), write ? "wb" : "rb");
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::optional<std::string> read_line(std::FILE* file)
+    {
+        std::string line;
+        int c;
+        while((c = std::fgetc(file)) != EOF && c != '\n')
+        {
+            if(line.size() >= MAX_Y4M_HEADER_LENGTH)
+                return std::nullopt;
+
+            line.push_back(static_cast<char>(c));
+        }
+
+        if(c == EOF && line.empty())
+            return std::nullopt;
+
+        return line;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    cv::Size YUVStreamFormat::chroma_size() const
+    {
+        switch(layout)
+        {
+            case ChromaLayout::YUV420: return {(size.width + 1) / 2, (size.height + 1) / 2};
+            case ChromaLayout::YUV422: return {(size.width + 1) / 2, size.height};
+            default: return size;
+        }
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    size_t YUVStreamFormat::frame_bytes() const
+    {
+        return static_cast<size_t>(size.area()) + 2 * static_cast<size_t>(chroma_size().area());
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool is_yuv_stream(const std::filesystem::path& path)
+    {
+        return path == "-" || path.extension() == ".y4m" || path.extension() == ".yuv";
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void pack_planes(const cv::UMat& y_plane, const cv::UMat& u_plane, const cv::UMat& v_plane, cv::UMat& dst)
+    {
+        LVK_ASSERT(y_plane.type() == CV_8UC1 && u_plane.type() == CV_8UC1 && v_plane.type() == CV_8UC1);
+        LVK_ASSERT(u_plane.size() == v_plane.size());
+
+        if(u_plane.size() != y_plane.size())
+        {
+            thread_local cv::UMat u_plane_full, v_plane_full;
+            cv::resize(u_plane, u_plane_full, y_plane.size(), 0, 0, cv::INTER_LINEAR);
+            cv::resize(v_plane, v_plane_full, y_plane.size(), 0, 0, cv::INTER_LINEAR);
+            cv::merge(std::vector<cv::UMat>{y_plane, u_plane_full, v_plane_full}, dst);
+        }
+        else cv::merge(std::vector<cv::UMat>{y_plane, u_plane, v_plane}, dst);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void bgr_to_yuv(const cv::Mat& src, cv::UMat& dst)
+    {
+        LVK_ASSERT(src.type() == CV_8UC3);
+
+        // NOTE: cv::COLOR_BGR2YUV produces full range YUV, which doesn't match the
+        // limited range of decoded frames, so the BT.601 matrix is applied directly.
+        static const cv::Matx34f bgr_to_yuv_matrix(
+             0.098f,  0.504f,  0.257f,  16.0f,
+             0.439f, -0.291f, -0.148f, 128.0f,
+            -0.071f, -0.368f,  0.439f, 128.0f
+        );
+        cv::transform(src, dst, bgr_to_yuv_matrix);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void yuv_to_bgr(const cv::UMat& src, cv::Mat& dst)
+    {
+        LVK_ASSERT(src.type() == CV_8UC3);
+
+        static const cv::Matx34f yuv_to_bgr_matrix(
+            1.164f,  2.018f,  0.000f, -276.928f,
+            1.164f, -0.391f, -0.813f,  135.488f,
+            1.164f,  0.000f,  1.596f, -222.912f
+        );
+        cv::transform(src, dst, yuv_to_bgr_matrix);
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    YUVStreamReader::~YUVStreamReader()
+    {
+        close();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::optional<std::string> YUVStreamReader::open(
+        const std::filesystem::path& path,
+        const YUVStreamFormat& raw_format
+    )
+    {
+        close();
+
+        m_File = open_stream(path, false, m_OwnsFile);
+        if(m_File == nullptr)
+            return cv::format("Failed to open the input stream \'%s\'", path.string().c_str());
+
+        if(path.extension() == ".yuv")
+        {
+            m_Format = raw_format;
+            m_Format.raw = true;
+        }
+        else if(auto error = parse_header(); error.has_value())
+            return error;
+
+        if(m_Format.size.empty())
+            return "Unknown input stream resolution";
+
+        // NOTE: one host buffer holds all the planes of a frame, so each
+        // frame can be read from the stream in a single read operation.
+        m_HostBuffer.create(1, static_cast<int>(m_Format.frame_bytes()), CV_8UC1);
+
+        // Estimate the amount of frames if we know the size of the stream.
+        m_FrameCount = 0;
+        if(std::error_code error; m_OwnsFile && std::filesystem::is_regular_file(path, error))
+        {
+            const auto header_bytes = static_cast<uintmax_t>(std::ftell(m_File));
+            const auto stream_bytes = std::filesystem::file_size(path, error);
+            const auto record_bytes = m_Format.frame_bytes()
+                + (m_Format.raw ? 0 : std::char_traits<char>::length(Y4M_FRAME_SIGNATURE) + 1);
+
+            if(!error && stream_bytes > header_bytes)
+                m_FrameCount = (stream_bytes - header_bytes) / record_bytes;
+        }
+
+        return std::nullopt;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::optional<std::string> YUVStreamReader::parse_header()
+    {
+        const auto header = read_line(m_File);
+        if(!header.has_value() || header->rfind(Y4M_SIGNATURE, 0) != 0)
+            return "Invalid YUV4MPEG2 stream, missing stream header";
+
+        m_Format = YUVStreamFormat{};
+        m_Format.raw = false;
+
+        std::istringstream tokens(header->substr(std::char_traits<char>::length(Y4M_SIGNATURE)));
+        std::string token;
+        while(tokens >> token)
+        {
+            const char tag = token.front();
+            const std::string value = token.substr(1);
+
+            try
+            {
+                switch(tag)
+                {
+                    case 'W':
+                        m_Format.size.width = std::stoi(value);
+                        break;
+                    case 'H':
+                        m_Format.size.height = std::stoi(value);
+                        break;
+                    case 'F':
+                    {
+                        const auto separator = value.find(':');
+                        const double numerator = std::stod(value.substr(0, separator));
+                        const double denominator = separator == std::string::npos
+                            ? 1.0 : std::stod(value.substr(separator + 1));
+
+                        if(numerator > 0 && denominator > 0)
+                            m_Format.framerate = numerator / denominator;
+                        break;
+                    }
+                    case 'C':
+                    {
+                        // NOTE: only 8-bit colour spaces are supported.
+                        const bool high_depth = value.size() > 4 && value[3] == 'p' && std::isdigit(value[4]);
+                        if(value.rfind("420", 0) == 0 && !high_depth)
+                            m_Format.layout = ChromaLayout::YUV420;
+                        else if(value == "422")
+                            m_Format.layout = ChromaLayout::YUV422;
+                        else if(value == "444")
+                            m_Format.layout = ChromaLayout::YUV444;
+                        else
+                            return cv::format("Unsupported YUV4MPEG2 colour space \'%s\'", value.c_str());
+                        break;
+                    }
+                    default:
+                        // Ignore interlacing, aspect ratio and extension parameters.
+                        break;
+                }
+            }
+            catch(const std::exception&)
+            {
+                return cv::format("Invalid YUV4MPEG2 stream parameter \'%s\'", token.c_str());
+            }
+        }
+
+        return std::nullopt;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool YUVStreamReader::skip_frame_header()
+    {
+        if(m_Format.raw)
+            return true;
+
+        const auto header = read_line(m_File);
+        return header.has_value() && header->rfind(Y4M_FRAME_SIGNATURE, 0) == 0;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool YUVStreamReader::read(lvk::Frame& frame)
+    {
+        LVK_ASSERT(m_File != nullptr);
+
+        if(!skip_frame_header())
+            return false;
+
+        const size_t frame_bytes = m_Format.frame_bytes();
+        if(std::fread(m_HostBuffer.data, 1, frame_bytes, m_File) != frame_bytes)
+            return false;
+
+        // Wrap each plane of the host buffer, then upload and interleave
+        // them into the packed YUV format used by the LVK filters.
+        const cv::Size luma_size = m_Format.size, chroma_size = m_Format.chroma_size();
+        uint8_t* y_data = m_HostBuffer.data;
+        uint8_t* u_data = y_data + luma_size.area();
+        uint8_t* v_data = u_data + chroma_size.area();
+
+        cv::Mat(luma_size, CV_8UC1, y_data).copyTo(m_YPlane);
+        cv::Mat(chroma_size, CV_8UC1, u_data).copyTo(m_UPlane);
+        cv::Mat(chroma_size, CV_8UC1, v_data).copyTo(m_VPlane);
+        pack_planes(m_YPlane, m_UPlane, m_VPlane, frame.data);
+
+        frame.timestamp = static_cast<uint64_t>(
+            lvk::Time::Timestep(m_Format.framerate).nanoseconds() * static_cast<double>(m_FramesRead)
+        );
+        m_FramesRead++;
+
+        return true;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void YUVStreamReader::close()
+    {
+        if(m_File != nullptr && m_OwnsFile)
+            std::fclose(m_File);
+
+        m_File = nullptr;
+        m_FramesRead = 0;
+        m_FrameCount = 0;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const YUVStreamFormat& YUVStreamReader::format() const
+    {
+        return m_Format;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t YUVStreamReader::frames_read() const
+    {
+        return m_FramesRead;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    uint64_t YUVStreamReader::frame_count() const
+    {
+        return m_FrameCount;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    YUVStreamWriter::~YUVStreamWriter()
+    {
+        close();
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    std::optional<std::string> YUVStreamWriter::open(
+        const std::filesystem::path& path,
+        const YUVStreamFormat& format
+    )
+    {
+        LVK_ASSERT(!format.size.empty());
+        LVK_ASSERT(format.framerate > 0);
+
+        close();
+
+        m_File = open_stream(path, true, m_OwnsFile);
+        if(m_File == nullptr)
+            return cv::format("Failed to create an output stream at \'%s\'", path.string().c_str());
+
+        m_Format = format;
+        m_Format.raw = path.extension() == ".yuv";
+        m_HostBuffer.create(1, static_cast<int>(m_Format.frame_bytes()), CV_8UC1);
+
+        if(!m_Format.raw)
+        {
+            // Represent the framerate as a ratio, preferring NTSC style ratios where they apply.
+            int64_t numerator = std::llround(m_Format.framerate * 1000.0), denominator = 1000;
+            if(const double ntsc_rate = m_Format.framerate * 1.001; std::abs(ntsc_rate - std::round(ntsc_rate)) < 1e-3)
+            {
+                numerator = std::llround(ntsc_rate) * 1000;
+                denominator = 1001;
+            }
+            const auto divisor = std::gcd(numerator, denominator);
+
+            const char* colour_space = "444";
+            if(m_Format.layout == ChromaLayout::YUV420) colour_space = "420jpeg";
+            else if(m_Format.layout == ChromaLayout::YUV422) colour_space = "422";
+
+            const auto header = cv::format(
+                "%s W%d H%d F%lld:%lld Ip A1:1 C%s\n",
+                Y4M_SIGNATURE,
+                m_Format.size.width,
+                m_Format.size.height,
+                static_cast<long long>(numerator / divisor),
+                static_cast<long long>(denominator / divisor),
+                colour_space
+            );
+
+            if(std::fwrite(header.data(), 1, header.size(), m_File) != header.size())
+                return "Failed to write the YUV4MPEG2 stream header";
+        }
+
+        return std::nullopt;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool YUVStreamWriter::write(const cv::UMat& frame)
+    {
+        LVK_ASSERT(m_File != nullptr);
+        LVK_ASSERT(frame.type() == CV_8UC3);
+        LVK_ASSERT(frame.size() == m_Format.size);
+
+        // De-interleave the packed YUV frame, then download each
+        // plane directly into its place within the host buffer.
+        const cv::Size luma_size = m_Format.size, chroma_size = m_Format.chroma_size();
+        uint8_t* y_data = m_HostBuffer.data;
+        uint8_t* u_data = y_data + luma_size.area();
+        uint8_t* v_data = u_data + chroma_size.area();
+
+        cv::split(frame, m_Planes);
+        m_Planes[0].copyTo(cv::Mat(luma_size, CV_8UC1, y_data));
+
+        if(chroma_size != luma_size)
+        {
+            cv::resize(m_Planes[1], m_UPlane, chroma_size, 0, 0, cv::INTER_AREA);
+            cv::resize(m_Planes[2], m_VPlane, chroma_size, 0, 0, cv::INTER_AREA);
+            m_UPlane.copyTo(cv::Mat(chroma_size, CV_8UC1, u_data));
+            m_VPlane.copyTo(cv::Mat(chroma_size, CV_8UC1, v_data));
+        }
+        else
+        {
+            m_Planes[1].copyTo(cv::Mat(chroma_size, CV_8UC1, u_data));
+            m_Planes[2].copyTo(cv::Mat(chroma_size, CV_8UC1, v_data));
+        }
+
+        if(!m_Format.raw)
+        {
+            const std::string frame_header = std::string(Y4M_FRAME_SIGNATURE) + "\n";
+            if(std::fwrite(frame_header.data(), 1, frame_header.size(), m_File) != frame_header.size())
+                return false;
+        }
+
+        const size_t frame_bytes = m_Format.frame_bytes();
+        return std::fwrite(m_HostBuffer.data, 1, frame_bytes, m_File) == frame_bytes;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    void YUVStreamWriter::close()
+    {
+        if(m_File != nullptr)
+        {
+            if(m_OwnsFile)
+                std::fclose(m_File);
+            else
+                std::fflush(m_File);
+        }
+        m_File = nullptr;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+    const YUVStreamFormat& YUVStreamWriter::format() const
+    {
+        return m_Format;
+    }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,146 @@
+//     *************************** LiveVisionKit ****************************
+//     Copyright (C) 2022  Sebastian Di Marco (crowsinc.dev@gmail.com)
+//
+//     This program is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//     **********************************************************************
+
+#pragma once
+
+#include <LiveVisionKit.hpp>
+#include <filesystem>
+#include <optional>
+#include <cstdio>
+
+namespace clt
+{
+
+    enum class ChromaLayout
+    {
+        YUV420,
+        YUV422,
+        YUV444
+    };
+
+    struct YUVStreamFormat
+    {
+        cv::Size size;
+        double framerate = 30.0;
+        ChromaLayout layout = ChromaLayout::YUV420;
+
+        // Raw streams have no headers and need their format to be known upfront.
+        bool raw = false;
+
+        cv::Size chroma_size() const;
+
+        size_t frame_bytes() const;
+    };
+
+    // Returns true if the path refers to a YUV4MPEG2 or raw YUV stream,
+    // with '-' referring to stdin or stdout.
+    bool is_yuv_stream(const std::filesystem::path& path);
+
+    // Interleaves 8-bit planar YUV into the packed YUV format used by the LVK filters,
+    // upsampling the chroma planes to the luma resolution if they are subsampled.
+    void pack_planes(const cv::UMat& y_plane, const cv::UMat& u_plane, const cv::UMat& v_plane, cv::UMat& dst);
+
+    // Single pass conversions between BGR and packed limited range BT.601 YUV, which is
+    // the YUV standard of the decoders and the YUV4MPEG2 streams used by the CLT.
+    void bgr_to_yuv(const cv::Mat& src, cv::UMat& dst);
+
+    void yuv_to_bgr(const cv::UMat& src, cv::Mat& dst);
+
+
+    // Reads YUV4MPEG2 or raw planar 8-bit YUV frames directly into packed YUV frames,
+    // bypassing the colour conversions and buffering of cv::VideoCapture.
+    class YUVStreamReader
+    {
+    public:
+
+        YUVStreamReader() = default;
+
+        ~YUVStreamReader();
+
+        YUVStreamReader(const YUVStreamReader&) = delete;
+
+        YUVStreamReader& operator=(const YUVStreamReader&) = delete;
+
+
+        // NOTE: the raw format is only used for raw '.yuv' streams.
+        std::optional<std::string> open(const std::filesystem::path& path, const YUVStreamFormat& raw_format);
+
+        bool read(lvk::Frame& frame);
+
+        void close();
+
+
+        const YUVStreamFormat& format() const;
+
+        uint64_t frames_read() const;
+
+        // NOTE: returns zero if the length of the stream is unknown.
+        uint64_t frame_count() const;
+
+    private:
+
+        std::optional<std::string> parse_header();
+
+        bool skip_frame_header();
+
+    private:
+        std::FILE* m_File = nullptr;
+        bool m_OwnsFile = false;
+
+        YUVStreamFormat m_Format;
+        uint64_t m_FramesRead = 0, m_FrameCount = 0;
+
+        cv::Mat m_HostBuffer;
+        cv::UMat m_YPlane, m_UPlane, m_VPlane;
+    };
+
+
+    // Writes packed YUV frames as YUV4MPEG2 or raw planar 8-bit YUV.
+    class YUVStreamWriter
+    {
+    public:
+
+        YUVStreamWriter() = default;
+
+        ~YUVStreamWriter();
+
+        YUVStreamWriter(const YUVStreamWriter&) = delete;
+
+        YUVStreamWriter& operator=(const YUVStreamWriter&) = delete;
+
+
+        std::optional<std::string> open(const std::filesystem::path& path, const YUVStreamFormat& format);
+
+        bool write(const cv::UMat& frame);
+
+        void close();
+
+
+        const YUVStreamFormat& format() const;
+
+    private:
+        std::FILE* m_File = nullptr;
+        bool m_OwnsFile = false;
+
+        YUVStreamFormat m_Format;
+
+        cv::Mat m_HostBuffer;
+        std::vector<cv::UMat> m_Planes;
+        cv::UMat m_UPlane, m_VPlane;
+    };
+
+}
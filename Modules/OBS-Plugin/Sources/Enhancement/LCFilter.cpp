@@ -83,11 +83,10 @@ namespace lvk
 		{
 			if(auto parameters = CCTool::LoadProfile(profile); parameters.has_value())
 			{
-				m_Parameters = *parameters;
+				m_Filter.reconfigure([&](LensCorrectionFilterSettings& settings) {
+					settings.camera_parameters = *parameters;
+				});
 				m_Profile = profile;
-
-				// Reset the undistort field to load in new profiles
-                m_FieldOutdated = true;
 			}
 			else m_ProfileSelected = false;
 		}
@@ -95,53 +94,12 @@ namespace lvk
 
 //---------------------------------------------------------------------------------------------------------------------
 
-	void LCFilter::prepare_undistort_maps(cv::UMat& frame)
-	{
-		// Update undistort map if it is outdated or missing
-		if(m_FieldOutdated || m_CorrectionField.size() != frame.size())
-		{
-            cv::Rect view_region;
-			cv::Mat optimal_camera_matrix = cv::getOptimalNewCameraMatrix(
-				m_Parameters.camera_matrix,
-				m_Parameters.distortion_coefficients,
-				frame.size(),
-				0,
-				frame.size(),
-				&view_region
-			);
-
-            cv::Mat correction_map;
-			cv::initUndistortRectifyMap(
-				m_Parameters.camera_matrix,
-				m_Parameters.distortion_coefficients,
-				cv::noArray(),
-				optimal_camera_matrix,
-				frame.size(),
-				CV_32FC2,
-                correction_map,
-				cv::noArray()
-			);
-
-            // Convert the correction map to a warp field.
-            m_CorrectionField.set_to(std::move(correction_map), false);
-            m_CorrectionField.crop_in(view_region, frame.size());
-            m_FieldOutdated = false;
-		}
-	}
-
-//---------------------------------------------------------------------------------------------------------------------
-
-	void LCFilter::filter(cv::UMat& frame)
+	void LCFilter::filter(FrameBuffer& frame)
 	{
         LVK_PROFILE;
 
 		if(m_ProfileSelected)
-		{
-			prepare_undistort_maps(frame);
-
-            m_CorrectionField.apply(frame, m_CorrectedFrame, true);
-            std::swap(frame, m_CorrectedFrame);
-		}
+			m_Filter.process(frame, frame);
 	}
 
 //---------------------------------------------------------------------------------------------------------------------
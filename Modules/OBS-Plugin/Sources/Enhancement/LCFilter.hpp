@@ -40,20 +40,14 @@ namespace lvk
 
 	private:
 
-		void prepare_undistort_maps(cv::UMat& frame);
-
-		void filter(cv::UMat& frame) override;
+		void filter(FrameBuffer& frame) override;
 
 	private:
 		obs_source_t* m_Context = nullptr;
 		bool m_ProfileSelected = false;
 
 		std::string m_Profile;
-		CameraParameters m_Parameters;
-
-        cv::UMat m_CorrectedFrame{cv::UMatUsageFlags::USAGE_ALLOCATE_DEVICE_MEMORY};
-        WarpField m_CorrectionField{WarpField::MinimumSize};
-        bool m_FieldOutdated = true;
+		LensCorrectionFilter m_Filter;
 	};
 
 }
@@ -258,7 +258,7 @@ namespace lvk
 	CCTool::CCTool(obs_source_t* context)
 		: VisionFilter(context),
 		  m_Context(context),
-		  m_Calibrator({CALIBRATION_PATTERN_COLS, CALIBRATION_PATTERN_ROWS}),
+		  m_Calibrator(cv::Size(CALIBRATION_PATTERN_COLS, CALIBRATION_PATTERN_ROWS)),
           m_SquareSize(SQUARE_SIZE_DEFAULT)
 	{
 		reset();